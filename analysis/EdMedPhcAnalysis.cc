@@ -0,0 +1,231 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhcAnalysis.cc
+/// \brief Main program of the analysis of the simulation output
+
+// Usage: EdMedPhc_analysis [particle ...] [-d datasetDir] [-O outputDir]
+//                          [-r tumourRadius_cm] [-z zMax_mm] [-w zWidth_mm]
+//                          [-x editedXMax_cm] [-t nThreads] [-P]
+//
+// Replaces the root processes that script.sh started per particle and
+// macro. Each <datasetDir>/<particle>.root (gammas and neutrons by 
+// default) is opened once and its ntuple read once, all particles 
+// concurrently with the threads shared among them, and the analysis 
+// results feed every stage:
+// - analyse_dose.C: summary, hZ and hDose
+// - make_histos.C:  hXY, hZR and hZXY
+// - edit_histo.C:   Edep_vs_z with the Z axis cut at editedXMax (60 cm)
+// - plot_same.C:    Edep_vs_z of all particles overlaid
+// The pdf and root files of the macros are written to outputDir unless
+// -P (summaries only) is given.
+// When <datasetDir>/<particle>_manifest.csv exists, the deposits are 
+// read from the thread files it lists (/EdMedPh/output/mergeThreadFiles
+// false) as one dataset; otherwise when <datasetDir>/<particle>_hits.edmc
+// exists, from that columnar file (/EdMedPh/output/stepFormat columnar)
+// instead of the ntuple.
+
+#include "EdMedPhDataset.hh"
+#include "EdMedPhDoseAnalysis.hh"
+#include "EdMedPhPlotter.hh"
+
+#include "TROOT.h"
+#include "TH1D.h"
+#include "TF1.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+  void PrintUsage() 
+  {
+    std::cerr 
+      << " Usage: EdMedPhc_analysis [particle ...] [-d datasetDir]"
+      << " [-O outputDir]" << std::endl
+      << "                          [-r tumourRadius_cm] [-z zMax_mm]"
+      << " [-w zWidth_mm]" << std::endl
+      << "                          [-x editedXMax_cm] [-t nThreads] [-P]" 
+      << std::endl;
+  }
+
+  void PrintSummary(const EdMedPhDataset& dataset, double zMax)
+  {
+    auto dose = dataset.GetDose();
+    auto hZ = dose->GetZHistogram();
+    auto fit = dose->GetFallOffFit();
+    auto zTumour = dose->GetTumourZ()/10.;
+    auto nofEvents = dose->GetNofEvents();
+    const auto& particle = dataset.GetParticle();
+
+    std::cout << std::endl
+      << " Data for " << particle << std::endl
+      << " Maximum deposited energy = " << hZ->GetMaximum() 
+      << " MeV, at Z = " << zTumour << " cm " << std::endl
+      << std::endl
+      << " Total Dose = " << hZ->Integral() << std::endl
+      << std::endl
+      << " Fit to exponential decrease: exp(" << fit->GetParameter(0) 
+      << " - " << std::abs(fit->GetParameter(1)) << " z)" << std::endl
+      << "Total Edep: " << dose->GetTotalEdep() << std::endl
+      << "Average Edep per event: " 
+      << dose->GetTotalEdep()/nofEvents << std::endl
+      << "Average Edep for non_null events: " 
+      << dose->GetTotalEdep()/dose->GetNofNonNullEvents() << std::endl
+      << "Tumor dose about " << zTumour << ": " 
+      << dose->GetTumourEdep() << std::endl
+      << "Healty dose: " << dose->GetHealthyEdep() << std::endl
+      << dose->GetMaxEventEdep() << std::endl;
+
+    if ( dose->GetNofOutOfRange() > 0 ) {
+      std::cerr << " Warning: " << dose->GetNofOutOfRange() 
+                << " deposits of " << particle << " beyond Z = " << zMax 
+                << " mm are missing from hZ and the tumour sum (see -z)" 
+                << std::endl;
+    }
+    std::cout << " ----> " << particle << ": " << dose->GetNofHits() 
+              << " deposits of " << nofEvents << " events analysed in " 
+              << dataset.GetElapsedTime() << " s with " 
+              << dataset.GetNofThreads() << " threads" << std::endl;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+int main(int argc, char** argv)
+{
+  std::vector<std::string> particles;
+  std::string datasetDirectory = "datasets";
+  std::string outputDirectory = ".";
+  double radius = 0.;
+  double zMax = 600.;
+  double zWidth = 0.1;
+  double editedXMax = 60.;
+  int nofThreads = std::max(1u, std::thread::hardware_concurrency());
+  bool plot = true;
+
+  for ( int i = 1; i < argc; ++i ) {
+    std::string arg = argv[i];
+    if ( arg[0] != '-' ) { particles.push_back(arg); continue; }
+    if ( arg == "-P" ) { plot = false; continue; }
+    if ( i + 1 >= argc ) { PrintUsage(); return 1; }
+    std::string value = argv[++i];
+    if      ( arg == "-d" ) datasetDirectory = value;
+    else if ( arg == "-O" ) outputDirectory = value;
+    else if ( arg == "-r" ) radius = std::atof(value.c_str());
+    else if ( arg == "-z" ) zMax = std::atof(value.c_str());
+    else if ( arg == "-w" ) zWidth = std::atof(value.c_str());
+    else if ( arg == "-x" ) editedXMax = std::atof(value.c_str());
+    else if ( arg == "-t" ) nofThreads = std::max(1, std::atoi(value.c_str()));
+    else { PrintUsage(); return 1; }
+  }
+  if ( particles.empty() ) particles = { "gammas", "neutrons" };
+
+  try {
+    ROOT::EnableThreadSafety();
+
+    std::vector<std::unique_ptr<EdMedPhDataset>> datasets;
+    for ( const auto& particle : particles ) {
+      std::cout << "Processing " << particle << std::endl;
+      auto fileName = datasetDirectory + "/" + particle;
+      std::vector<std::string> hitFileNames;
+      if ( std::ifstream(fileName + "_manifest.csv") ) {
+        hitFileNames = EdMedPhFileSet::ReadManifest(fileName + "_manifest.csv");
+      }
+      else if ( std::ifstream(fileName + "_hits.edmc") ) {
+        hitFileNames.push_back(fileName + "_hits.edmc");
+      }
+      datasets.emplace_back(
+        new EdMedPhDataset(particle, fileName + ".root", hitFileNames));
+    }
+
+    // All particles concurrently, sharing the threads
+    auto nofDatasets = int(datasets.size());
+    std::vector<std::thread> threads;
+    std::vector<std::exception_ptr> errors(nofDatasets);
+    for ( int i = 0; i < nofDatasets; ++i ) {
+      auto threadsOfDataset 
+        = std::max(1, nofThreads/nofDatasets + (i < nofThreads%nofDatasets));
+      // tumour radii of the macros unless given
+      auto tumourRadius = radius;
+      if ( tumourRadius <= 0. ) {
+        const auto& particle = particles[i];
+        tumourRadius 
+          = ( particle == "gammas" || particle == "neutrons" ) ? 2. : 3.;
+      }
+      threads.emplace_back([&, i, threadsOfDataset, tumourRadius]() {
+        try {
+          datasets[i]->Analyse(threadsOfDataset, tumourRadius*10., 
+                               zMax, zWidth);
+        }
+        catch ( ... ) {
+          errors[i] = std::current_exception();
+        }
+      });
+    }
+    for ( auto& thread : threads ) thread.join();
+    for ( auto& error : errors ) {
+      if ( error ) std::rethrow_exception(error);
+    }
+
+    for ( const auto& dataset : datasets ) PrintSummary(*dataset, zMax);
+
+    if ( plot ) {
+      auto start = std::chrono::steady_clock::now();
+
+      EdMedPhPlotter plotter(outputDirectory);
+      std::vector<const EdMedPhDataset*> overlay;
+      for ( const auto& dataset : datasets ) {
+        plotter.PlotDose(*dataset);
+        plotter.PlotHistos(*dataset);
+        plotter.PlotEditedHisto(*dataset, editedXMax);
+        overlay.push_back(dataset.get());
+      }
+      plotter.PlotSame(overlay);
+
+      std::chrono::duration<double> elapsed 
+        = std::chrono::steady_clock::now() - start;
+      std::cout << " ----> plots written to " << outputDirectory << " in " 
+                << elapsed.count() << " s" << std::endl;
+    }
+  }
+  catch ( const std::exception& e ) {
+    std::cerr << " Error: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,364 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhcMerge.cc
+/// \brief Main program of the merge of the outputs of a split job
+
+// Usage: EdMedPhc_merge output shard1 shard2 ...
+//        EdMedPhc_merge -c reference output [-e tolerance]
+//
+// Combines the outputs of the shards of a job split with the -s option
+// of exampleEdMedPhc, given by their output names (-o), into the output
+// of the whole job:
+// - <name>_dose.bin: the energy deposits of the voxels are added,
+// - <name>_roi.csv: the energy deposits, their squares and the events of
+//   each region are added, then the uncertainties and doses recomputed.
+// Both are additive, so the result equals the output of a single process
+// up to the rounding of the sums. The histograms and ntuples of the 
+// <name>.root files are merged with ROOT's hadd; the dose-volume 
+// histograms are not additive and are not merged.
+//
+// With -c, compares two outputs instead: the largest voxel difference
+// relative to the maximum voxel, and the relative differences of the 
+// region sums, and fails when one exceeds the tolerance (1e-9), when a
+// _dose.bin or _roi.csv of either output is missing or unreadable, or
+// when there is nothing to compare.
+// Needs neither ROOT nor Geant4.
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+  void PrintUsage() 
+  {
+    std::cerr 
+      << " Usage: EdMedPhc_merge output shard1 shard2 ..." << std::endl
+      << "        EdMedPhc_merge -c reference output [-e tolerance]" 
+      << std::endl;
+  }
+
+  // <name>_dose.bin, see EdMedPhDoseGrid::Write()
+  struct DoseMap
+  {
+    std::int32_t         dims[3];
+    double               corners[6];
+    std::vector<double>  edep;
+  };
+
+  bool ReadDoseMap(const std::string& fileName, DoseMap& map)
+  {
+    std::ifstream file(fileName, std::ios::binary);
+    if ( ! file ) return false;
+
+    char magic[8];
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(map.dims), sizeof(map.dims));
+    file.read(reinterpret_cast<char*>(map.corners), sizeof(map.corners));
+    if ( ! file || std::memcmp(magic, "EDMPDOSE", sizeof(magic)) != 0 ) {
+      throw std::runtime_error(fileName + " is not a dose map");
+    }
+    map.edep.resize(std::size_t(map.dims[0])*map.dims[1]*map.dims[2]);
+    file.read(reinterpret_cast<char*>(map.edep.data()), 
+              map.edep.size()*sizeof(double));
+    if ( ! file ) throw std::runtime_error(fileName + " is truncated");
+    return true;
+  }
+
+  void WriteDoseMap(const std::string& fileName, const DoseMap& map)
+  {
+    std::ofstream file(fileName, std::ios::binary);
+    if ( ! file ) throw std::runtime_error("Cannot open " + fileName);
+    file.write("EDMPDOSE", 8);
+    file.write(reinterpret_cast<const char*>(map.dims), sizeof(map.dims));
+    file.write(reinterpret_cast<const char*>(map.corners), 
+               sizeof(map.corners));
+    file.write(reinterpret_cast<const char*>(map.edep.data()), 
+               map.edep.size()*sizeof(double));
+  }
+
+  // <name>_roi.csv, see EdMedPhRunAction::WriteROISummary()
+  struct Region
+  {
+    std::string  name;
+    std::string  shape;
+    std::string  volume;       // cm3, empty outside the regions
+    double       edep = 0.;    // MeV
+    double       edep2 = 0.;   // MeV2
+    std::int64_t nofEvents = 0;
+  };
+
+  bool ReadRegions(const std::string& fileName, std::vector<Region>& regions)
+  {
+    std::ifstream file(fileName);
+    if ( ! file ) return false;
+
+    std::string line;
+    std::getline(file, line);
+    if ( line.find(",events,edep2_MeV2") == std::string::npos ) {
+      throw std::runtime_error(fileName 
+        + " has no events and edep2_MeV2 columns, it cannot be merged");
+    }
+    while ( std::getline(file, line) ) {
+      if ( line.empty() ) continue;
+      std::vector<std::string> fields;
+      std::istringstream is(line);
+      std::string field;
+      while ( std::getline(is, field, ',') ) fields.push_back(field);
+      if ( fields.size() != 9 ) {
+        throw std::runtime_error("Bad line in " + fileName + ": " + line);
+      }
+      Region region;
+      region.name = fields[0];
+      region.shape = fields[1];
+      region.volume = fields[2];
+      region.edep = std::atof(fields[3].c_str());
+      region.nofEvents = std::atoll(fields[7].c_str());
+      region.edep2 = std::atof(fields[8].c_str());
+      regions.push_back(region);
+    }
+    return true;
+  }
+
+  void WriteRegions(const std::string& fileName, 
+                    const std::vector<Region>& regions)
+  {
+    std::ofstream file(fileName);
+    if ( ! file ) throw std::runtime_error("Cannot open " + fileName);
+
+    // dose for water, 1 g/cm3
+    const double joulePerMeV = 1.602176634e-13;
+    file << std::setprecision(std::numeric_limits<double>::max_digits10);
+    file << "roi,shape,volume_cm3,edep_MeV,edep_err_MeV,dose_Gy,dose_err_Gy,"
+         << "events,edep2_MeV2\n";
+    for ( const auto& region : regions ) {
+      auto nofEvents = region.nofEvents;
+      auto edepError = nofEvents > 0 
+        ? std::sqrt(std::max(0., region.edep2 
+                                 - region.edep*region.edep/nofEvents)) : 0.;
+      file << region.name << "," << region.shape << "," << region.volume 
+           << "," << region.edep << "," << edepError << ",";
+      auto mass = std::atof(region.volume.c_str())*1e-3;  // kg
+      if ( mass > 0. ) {
+        file << region.edep*joulePerMeV/mass << "," 
+             << edepError*joulePerMeV/mass;
+      }
+      else if ( ! region.volume.empty() ) {
+        file << "0,0";
+      }
+      else {
+        file << ",";
+      }
+      file << "," << nofEvents << "," << region.edep2 << "\n";
+    }
+  }
+
+  int Merge(const std::string& output, const std::vector<std::string>& shards)
+  {
+    DoseMap dose;
+    std::size_t nofDoseMaps = 0;
+    std::vector<Region> regions;
+    std::size_t nofSummaries = 0;
+
+    for ( const auto& shard : shards ) {
+      DoseMap shardDose;
+      if ( ReadDoseMap(shard + "_dose.bin", shardDose) ) {
+        if ( nofDoseMaps++ == 0 ) {
+          dose = shardDose;
+        }
+        else {
+          if ( std::memcmp(dose.dims, shardDose.dims, sizeof(dose.dims)) != 0
+               || std::memcmp(dose.corners, shardDose.corners, 
+                              sizeof(dose.corners)) != 0 ) {
+            throw std::runtime_error(
+              shard + "_dose.bin has another grid than the first shard");
+          }
+          for ( std::size_t i = 0; i < dose.edep.size(); ++i ) {
+            dose.edep[i] += shardDose.edep[i];
+          }
+        }
+      }
+
+      std::vector<Region> shardRegions;
+      if ( ReadRegions(shard + "_roi.csv", shardRegions) ) {
+        if ( nofSummaries++ == 0 ) {
+          regions = shardRegions;
+          continue;
+        }
+        if ( shardRegions.size() != regions.size() ) {
+          throw std::runtime_error(
+            shard + "_roi.csv has other regions than the first shard");
+        }
+        for ( std::size_t i = 0; i < regions.size(); ++i ) {
+          if ( shardRegions[i].name != regions[i].name ) {
+            throw std::runtime_error(
+              shard + "_roi.csv has other regions than the first shard");
+          }
+          regions[i].edep += shardRegions[i].edep;
+          regions[i].edep2 += shardRegions[i].edep2;
+          regions[i].nofEvents += shardRegions[i].nofEvents;
+        }
+      }
+    }
+
+    if ( nofDoseMaps > 0 ) {
+      WriteDoseMap(output + "_dose.bin", dose);
+      std::cout << " " << nofDoseMaps << " dose map(s) added to " 
+                << output << "_dose.bin" << std::endl;
+    }
+    if ( nofSummaries > 0 ) {
+      WriteRegions(output + "_roi.csv", regions);
+      std::cout << " " << nofSummaries << " region summaries, " 
+                << regions.front().nofEvents << " events, added to " 
+                << output << "_roi.csv" << std::endl;
+    }
+    if ( nofDoseMaps != shards.size() || nofSummaries != shards.size() ) {
+      std::cerr << " Warning: " << shards.size() - nofDoseMaps 
+                << " dose map(s) and " << shards.size() - nofSummaries 
+                << " region summaries missing" << std::endl;
+    }
+    if ( nofDoseMaps + nofSummaries == 0 ) return 1;
+
+    std::cout << " Merge the histograms and ntuples with: hadd " 
+              << output << ".root";
+    for ( const auto& shard : shards ) std::cout << " " << shard << ".root";
+    std::cout << std::endl;
+    return 0;
+  }
+
+  double RelativeDifference(double a, double b)
+  {
+    auto scale = std::max(std::fabs(a), std::fabs(b));
+    return scale > 0. ? std::fabs(a - b)/scale : 0.;
+  }
+
+  int Compare(const std::string& reference, const std::string& output,
+              double tolerance)
+  {
+    // a shard that wrote nothing must not pass
+    DoseMap referenceDose, dose;
+    std::vector<Region> referenceRegions, regions;
+    if ( ! ReadDoseMap(reference + "_dose.bin", referenceDose) ) {
+      throw std::runtime_error("Cannot open " + reference + "_dose.bin");
+    }
+    if ( ! ReadDoseMap(output + "_dose.bin", dose) ) {
+      throw std::runtime_error("Cannot open " + output + "_dose.bin");
+    }
+    if ( ! ReadRegions(reference + "_roi.csv", referenceRegions) ) {
+      throw std::runtime_error("Cannot open " + reference + "_roi.csv");
+    }
+    if ( ! ReadRegions(output + "_roi.csv", regions) ) {
+      throw std::runtime_error("Cannot open " + output + "_roi.csv");
+    }
+    if ( dose.edep.empty() && regions.empty() ) {
+      throw std::runtime_error("The outputs have neither voxels nor regions");
+    }
+
+    double worst = 0.;
+
+    if ( referenceDose.edep.size() != dose.edep.size() ) {
+      throw std::runtime_error("The dose maps have different grids");
+    }
+    double maxEdep = 0.;
+    double maxDifference = 0.;
+    for ( std::size_t i = 0; i < dose.edep.size(); ++i ) {
+      maxEdep = std::max(maxEdep, std::fabs(referenceDose.edep[i]));
+      maxDifference = std::max(maxDifference, 
+                               std::fabs(dose.edep[i] 
+                                         - referenceDose.edep[i]));
+    }
+    auto difference = maxEdep > 0. ? maxDifference/maxEdep : 0.;
+    std::cout << " dose map : largest voxel difference " << difference 
+              << " of the maximum" << std::endl;
+    worst = std::max(worst, difference);
+
+    if ( referenceRegions.size() != regions.size() ) {
+      throw std::runtime_error("The region summaries differ in regions");
+    }
+    for ( std::size_t i = 0; i < regions.size(); ++i ) {
+      auto regionDifference = std::max(
+        RelativeDifference(referenceRegions[i].edep, regions[i].edep),
+        RelativeDifference(referenceRegions[i].edep2, regions[i].edep2));
+      if ( referenceRegions[i].nofEvents != regions[i].nofEvents ) {
+        regionDifference = 1.;
+      }
+      std::cout << " " << regions[i].name << " : relative difference " 
+                << regionDifference << std::endl;
+      worst = std::max(worst, regionDifference);
+    }
+
+    auto passed = ( worst <= tolerance );
+    std::cout << " ----> " << ( passed ? "same" : "DIFFERENT" ) 
+              << " within " << tolerance << std::endl;
+    return passed ? 0 : 1;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+int main(int argc, char** argv)
+{
+  std::vector<std::string> names;
+  bool compare = false;
+  double tolerance = 1e-9;
+
+  for ( int i = 1; i < argc; ++i ) {
+    std::string arg = argv[i];
+    if ( arg[0] != '-' ) { names.push_back(arg); continue; }
+    if ( arg == "-c" ) { compare = true; continue; }
+    if ( i + 1 >= argc ) { PrintUsage(); return 1; }
+    std::string value = argv[++i];
+    if ( arg == "-e" ) tolerance = std::atof(value.c_str());
+    else { PrintUsage(); return 1; }
+  }
+  if ( names.size() < 2 || ( compare && names.size() != 2 ) ) {
+    PrintUsage();
+    return 1;
+  }
+
+  try {
+    if ( compare ) return Compare(names[0], names[1], tolerance);
+    return Merge(names[0], 
+                 std::vector<std::string>(names.begin() + 1, names.end()));
+  }
+  catch ( const std::exception& e ) {
+    std::cerr << " Error: " << e.what() << std::endl;
+    return 1;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
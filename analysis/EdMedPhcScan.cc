@@ -0,0 +1,234 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhcScan.cc
+/// \brief Main program of the ROOT-free scan of a columnar hit file
+
+// Usage: EdMedPhc_scan file.edmc|manifest.csv ... [-t nThreads] 
+//                     [-z zMax_mm] [-w zWidth_mm] [-o profile.csv]
+//
+// Scans the deposits of columnar hit files (/EdMedPh/output/stepFormat 
+// columnar), given directly or as the hit files of an MT run manifest 
+// (/EdMedPh/output/mergeThreadFiles false), as one dataset: each file 
+// is read in place through EdMedPhColumnarReader and all the deposits
+// are split over nThreads contiguous ranges (EdMedPhFileSet), and prints the energy totals per run and per event,
+// the depth of the maximum of the Z profile and the scan throughput.
+// With -o the Z profile (zWidth bins up to zMax, in mm) is written as 
+// CSV. Needs neither ROOT nor Geant4, for nodes that only scan hits.
+
+#include "EdMedPhColumnarReader.hh"
+#include "EdMedPhColumnarHitSource.hh"
+#include "EdMedPhEventReducer.hh"
+#include "EdMedPhFileSet.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+  void PrintUsage() 
+  {
+    std::cerr 
+      << " Usage: EdMedPhc_scan file.edmc|manifest.csv ... [-t nThreads]"
+      << std::endl
+      << "                     [-z zMax_mm] [-w zWidth_mm] [-o profile.csv]"
+      << std::endl;
+  }
+
+  // the sums of one range of the file
+  struct Part
+  {
+    double               edep = 0.;
+    std::uint64_t        nofOutOfRange = 0;
+    std::vector<double>  profile;
+    EdMedPhEventReducer  events;
+  };
+
+  typedef std::vector<std::unique_ptr<EdMedPhColumnarReader>> Readers;
+
+  void ScanRange(const EdMedPhColumnarReader& reader, 
+                 std::int64_t first, std::int64_t last, 
+                 double zWidth, Part& part)
+  {
+    EdMedPhColumnarHitSource source(reader, first, last);
+    EdMedPhHitBlock block;
+    auto nofBins = part.profile.size();
+    while ( source.Next(block) ) {
+      for ( std::size_t i = 0; i < block.Size(); ++i ) {
+        auto edep = block.edep[i];
+        part.edep += edep;
+        part.events.Add(block.eventID[i], edep);
+
+        auto bin = block.z[i]/zWidth;
+        if ( bin >= 0. && bin < nofBins ) {
+          part.profile[std::size_t(bin)] += edep;
+        }
+        else {
+          ++part.nofOutOfRange;
+        }
+      }
+    }
+  }
+
+  void ScanPart(const EdMedPhFileSet& files, const Readers& readers,
+                int index, int nofParts, double zWidth, Part& part)
+  {
+    for ( const auto& range : files.Split(index, nofParts) ) {
+      ScanRange(*readers[range.file], range.first, range.last, zWidth, part);
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+int main(int argc, char** argv)
+{
+  std::vector<std::string> fileNames;
+  std::string profileFileName;
+  double zMax = 600.;
+  double zWidth = 1.;
+  int nofThreads = std::max(1u, std::thread::hardware_concurrency());
+
+  for ( int i = 1; i < argc; ++i ) {
+    std::string arg = argv[i];
+    if ( arg[0] != '-' ) { fileNames.push_back(arg); continue; }
+    if ( i + 1 >= argc ) { PrintUsage(); return 1; }
+    std::string value = argv[++i];
+    if      ( arg == "-o" ) profileFileName = value;
+    else if ( arg == "-z" ) zMax = std::atof(value.c_str());
+    else if ( arg == "-w" ) zWidth = std::atof(value.c_str());
+    else if ( arg == "-t" ) nofThreads = std::max(1, std::atoi(value.c_str()));
+    else { PrintUsage(); return 1; }
+  }
+  if ( fileNames.empty() || zWidth <= 0. || zMax <= 0. ) { 
+    PrintUsage(); 
+    return 1; 
+  }
+
+  try {
+    auto start = std::chrono::steady_clock::now();
+
+    EdMedPhFileSet files;
+    Readers readers;
+    std::size_t nofChunks = 0;
+    double nofBytes = 0.;
+    for ( const auto& name : fileNames ) {
+      auto isManifest = ( name.size() > 4 
+                          && name.compare(name.size() - 4, 4, ".csv") == 0 );
+      auto hitFileNames = isManifest 
+        ? EdMedPhFileSet::ReadManifest(name) : std::vector<std::string>{ name };
+      for ( const auto& hitFileName : hitFileNames ) {
+        readers.emplace_back(new EdMedPhColumnarReader(hitFileName));
+        files.Add(hitFileName, std::int64_t(readers.back()->GetNofRows()));
+        nofChunks += readers.back()->GetNofChunks();
+        nofBytes += readers.back()->GetMappingSize();
+      }
+    }
+    auto nofRows = files.GetNofEntries();
+    nofThreads = int(std::max(std::int64_t(1), 
+                              std::min(std::int64_t(nofThreads), nofRows)));
+
+    std::vector<Part> parts(nofThreads);
+    std::vector<std::thread> threads;
+    for ( int i = 0; i < nofThreads; ++i ) {
+      parts[i].profile.assign(std::size_t(zMax/zWidth + 0.5), 0.);
+      threads.emplace_back(ScanPart, std::cref(files), std::cref(readers), 
+                           i, nofThreads, zWidth, std::ref(parts[i]));
+    }
+    for ( auto& thread : threads ) thread.join();
+
+    // the ranges are in file order, so are the event sums
+    auto& total = parts[0];
+    for ( int i = 1; i < nofThreads; ++i ) {
+      total.edep += parts[i].edep;
+      total.nofOutOfRange += parts[i].nofOutOfRange;
+      for ( std::size_t bin = 0; bin < total.profile.size(); ++bin ) {
+        total.profile[bin] += parts[i].profile[bin];
+      }
+      total.events.Merge(parts[i].events);
+    }
+
+    std::chrono::duration<double> elapsed 
+      = std::chrono::steady_clock::now() - start;
+
+    const auto& events = total.events.GetEvents();
+    double maxEventEdep = 0.;
+    for ( const auto& event : events ) {
+      maxEventEdep = std::max(maxEventEdep, event.second);
+    }
+    auto peak = std::max_element(total.profile.begin(), total.profile.end());
+    auto nofEvents = total.events.GetMaxEventID() + 1;
+
+    std::cout 
+      << " " << files.GetNofFiles() << " file(s) : " << nofRows 
+      << " deposits in " << nofChunks << " chunks" << std::endl
+      << " Total Edep: " << total.edep << " MeV" << std::endl
+      << " Events: " << nofEvents << ", with deposits: " << events.size()
+      << std::endl
+      << " Average Edep per event: " 
+      << ( nofEvents > 0 ? total.edep/nofEvents : 0. ) << " MeV" << std::endl
+      << " Maximum Edep of an event: " << maxEventEdep << " MeV" << std::endl
+      << " Maximum of the Z profile at Z = " 
+      << ( peak - total.profile.begin() + 0.5 )*zWidth << " mm" << std::endl;
+    if ( total.nofOutOfRange > 0 ) {
+      std::cerr << " Warning: " << total.nofOutOfRange 
+                << " deposits outside Z = [0, " << zMax 
+                << "] mm are missing from the profile (see -z)" << std::endl;
+    }
+    std::cout << " ----> " << nofRows << " deposits scanned in " 
+              << elapsed.count() << " s with " << nofThreads << " threads : "
+              << nofRows/elapsed.count() << " deposits/s, "
+              << nofBytes/elapsed.count()/1e9 << " GB/s" 
+              << std::endl;
+
+    if ( ! profileFileName.empty() ) {
+      std::ofstream profile(profileFileName);
+      if ( ! profile ) {
+        throw std::runtime_error("Cannot open " + profileFileName);
+      }
+      profile << "z_mm,edep_MeV\n";
+      for ( std::size_t bin = 0; bin < total.profile.size(); ++bin ) {
+        profile << ( bin + 0.5 )*zWidth << "," << total.profile[bin] << "\n";
+      }
+    }
+  }
+  catch ( const std::exception& e ) {
+    std::cerr << " Error: " << e.what() << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
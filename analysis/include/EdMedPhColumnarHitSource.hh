@@ -0,0 +1,64 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhColumnarHitSource.hh
+/// \brief Definition of the EdMedPhColumnarHitSource class
+
+#ifndef EdMedPhColumnarHitSource_h
+#define EdMedPhColumnarHitSource_h 1
+
+#include "EdMedPhHitSource.hh"
+
+class EdMedPhColumnarReader;
+
+/// Reads the deposits [first, last) of a columnar hit file.
+///
+/// Each block is the part of one chunk within the range and points 
+/// directly into the reader's mapping: nothing is copied, so several 
+/// sources over one reader scan their ranges at memory bandwidth.
+/// Encoded chunks are decoded into the source's own columns first.
+/// Needs no ROOT.
+
+class EdMedPhColumnarHitSource : public EdMedPhHitSource
+{
+  public:
+    EdMedPhColumnarHitSource(const EdMedPhColumnarReader& reader, 
+                             std::int64_t first = 0, std::int64_t last = -1);
+    virtual ~EdMedPhColumnarHitSource() {}
+
+    virtual bool Next(EdMedPhHitBlock& block);
+    virtual std::int64_t GetNofHits() const { return fLast - fFirst; }
+
+  private:
+    const EdMedPhColumnarReader&  fReader;
+    std::int64_t  fFirst;
+    std::int64_t  fLast;
+    std::int64_t  fRow;
+    std::size_t   fChunk;
+    EdMedPhHitColumns  fColumns;
+};
+
+#endif
@@ -0,0 +1,99 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhColumnarReader.hh
+/// \brief Definition of the EdMedPhColumnarReader class
+
+#ifndef EdMedPhColumnarReader_h
+#define EdMedPhColumnarReader_h 1
+
+#include "EdMedPhColumnarFormat.hh"
+#include "EdMedPhHitSource.hh"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// The columns of one chunk of a columnar hit file, pointing into the
+/// mapped file. firstRow is the index of its first hit in the file.
+/// The typed column pointers are only set for raw chunks; encoded ones
+/// are read with EdMedPhColumnarReader::Decode().
+
+struct EdMedPhColumnarChunkView
+{
+  std::uint64_t       firstRow;
+  std::size_t         nofRows;
+  const EdMedPhColumnarChunk*  header;
+  const unsigned char*         columns[EdMedPhColumnar::kNofColumns];
+  const float*        edep;
+  const float*        x;
+  const float*        y;
+  const float*        z;
+  const std::int32_t* eventID;
+};
+
+/// Maps a columnar hit file (<output>_hits.edmc, see 
+/// EdMedPhColumnarFormat.hh) read-only and indexes its chunks.
+///
+/// The chunk views point into the mapping, so scans read the columns 
+/// straight from the page cache without copy or decoding, and any 
+/// number of threads can share one reader. Encoded chunks (see
+/// EdMedPhColumnarCodec.hh) are decoded by the caller's thread into its 
+/// own columns. It has no ROOT or Geant4 dependency; errors are reported
+/// with std::runtime_error.
+
+class EdMedPhColumnarReader
+{
+  public:
+    explicit EdMedPhColumnarReader(const std::string& fileName);
+    ~EdMedPhColumnarReader();
+
+    const std::string& GetFileName() const { return fFileName; }
+    std::uint64_t GetNofRows() const     { return fNofRows; }
+    std::size_t   GetNofChunks() const   { return fChunks.size(); }
+    std::size_t   GetMappingSize() const { return fMappingSize; }
+
+    const EdMedPhColumnarChunkView& GetChunk(std::size_t i) const 
+                                    { return fChunks[i]; }
+    // the chunk holding the given row, GetNofChunks() past the end
+    std::size_t FindChunk(std::uint64_t row) const;
+    // the hits of an encoded chunk
+    void Decode(std::size_t i, EdMedPhHitColumns& columns) const;
+
+  private:
+    EdMedPhColumnarReader(const EdMedPhColumnarReader&) = delete;
+    EdMedPhColumnarReader& operator=(const EdMedPhColumnarReader&) = delete;
+
+    void Index();
+
+    std::string    fFileName;
+    void*          fMapping;
+    std::size_t    fMappingSize;
+    std::uint64_t  fNofRows;
+    std::vector<EdMedPhColumnarChunkView>  fChunks;
+};
+
+#endif
@@ -0,0 +1,102 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhDataset.hh
+/// \brief Definition of the EdMedPhDataset class
+
+#ifndef EdMedPhDataset_h
+#define EdMedPhDataset_h 1
+
+#include "EdMedPhFileSet.hh"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class EdMedPhColumnarReader;
+class EdMedPhDoseAnalysis;
+class EdMedPhHistoAnalysis;
+class TH1D;
+
+/// The simulation output of one particle, datasets/<particle>.root, 
+/// and the results of all analysis stages on it.
+///
+/// The constructor reads the ntuple size and the Edep_vs_z histogram
+/// filled during the run; Analyse() then reads every ntuple entry 
+/// exactly once, split over nofThreads contiguous ranges each with its
+/// own TFile and private dose and histogram analyses, and merges them.
+/// The plotting stages only use the results kept here.
+///
+/// The deposits can instead come from other hit files, read as one 
+/// EdMedPhFileSet: the thread files of <particle>_manifest.csv 
+/// (/EdMedPh/output/mergeThreadFiles false) and/or columnar hit files 
+/// (<particle>_hits.edmc, /EdMedPh/output/stepFormat columnar). Each 
+/// columnar file is mapped once by an EdMedPhColumnarReader shared by 
+/// all threads; the ROOT file is then only needed for Edep_vs_z.
+
+class EdMedPhDataset
+{
+  public:
+    EdMedPhDataset(const std::string& particle, const std::string& fileName,
+                   const std::vector<std::string>& hitFileNames = {});
+    ~EdMedPhDataset();
+
+    void Analyse(int nofThreads, double tumourRadius, 
+                 double zMax, double zWidth);
+
+    const std::string& GetParticle() const { return fParticle; }
+    const std::string& GetFileName() const { return fFileName; }
+    const EdMedPhFileSet& GetHitFiles() const { return fHitFiles; }
+    std::int64_t GetNofEntries() const     { return fNofEntries; }
+    int          GetNofThreads() const     { return fNofThreads; }
+    double       GetElapsedTime() const    { return fElapsedTime; }
+
+    // results, available after Analyse()
+    EdMedPhDoseAnalysis*  GetDose() const   { return fDose.get(); }
+    EdMedPhHistoAnalysis* GetHistos() const { return fHistos.get(); }
+    // the Edep_vs_z histogram of the run, or nullptr if missing
+    TH1D*                 GetEdepVsZ() const { return fEdepVsZ; }
+
+  private:
+    EdMedPhDataset(const EdMedPhDataset&) = delete;
+    EdMedPhDataset& operator=(const EdMedPhDataset&) = delete;
+
+    std::string   fParticle;
+    std::string   fFileName;
+    EdMedPhFileSet  fHitFiles;
+    std::int64_t  fNofEntries;
+    int           fNofThreads;
+    double        fElapsedTime;
+
+    // one per hit file, nullptr for ntuple files
+    std::vector<std::unique_ptr<EdMedPhColumnarReader>>  fHitReaders;
+    std::unique_ptr<EdMedPhDoseAnalysis>   fDose;
+    std::unique_ptr<EdMedPhHistoAnalysis>  fHistos;
+    TH1D*                                  fEdepVsZ;
+};
+
+#endif
@@ -0,0 +1,128 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhDoseAnalysis.hh
+/// \brief Definition of the EdMedPhDoseAnalysis class
+
+#ifndef EdMedPhDoseAnalysis_h
+#define EdMedPhDoseAnalysis_h 1
+
+#include "EdMedPhEventReducer.hh"
+
+#include <cstdint>
+#include <vector>
+
+struct EdMedPhHitBlock;
+class TH1D;
+class TF1;
+class TDirectory;
+
+/// The analysis of root_macros/analyse_dose.C in a single pass.
+///
+/// The macro scans the ntuple three times for the Z and EventID ranges
+/// and then loops twice over it: for the energy profile and the energy 
+/// per event, then for the split between the tumour, a sphere centred
+/// on the Bragg peak, and the healthy tissue. Here every deposit is 
+/// visited once by Fill():
+/// - the profile along Z is accumulated with a fine fixed binning 
+///   (zWidth) and rebinned to the binning of the macro at the end, 
+///   once the Z range is known;
+/// - the deposits within the tumour radius of the beam axis are also
+///   accumulated in fine (Z, R^2) cells, so that the energy in the 
+///   sphere is summed at the end once its centre is known, to the 
+///   resolution of the cells;
+/// - the energy per event is summed by an EdMedPhEventReducer, which 
+///   keeps only the events with deposits and needs no prior scan of 
+///   the EventID range.
+/// Analyses of parts of the ntuple, e.g. filled by separate threads,
+/// are combined with Merge() before Finish() builds the hZ and hDose 
+/// histograms of the macro.
+/// Positions are in mm, as in the ntuple, the histograms in cm.
+
+class EdMedPhDoseAnalysis
+{
+  public:
+    EdMedPhDoseAnalysis(double tumourRadius, 
+                        double zMin = 0., double zMax = 600., 
+                        double zWidth = 0.1, int nofRho2Bins = 64);
+    ~EdMedPhDoseAnalysis();
+
+    void Fill(const EdMedPhHitBlock& block);
+    void Merge(EdMedPhDoseAnalysis& other);
+    void Finish();
+
+    // write hZ and hDose to the given directory
+    void Write(TDirectory* directory) const;
+
+    // results, available after Finish()
+    TH1D*  GetZHistogram() const    { return fHZ; }
+    TH1D*  GetDoseHistogram() const { return fHDose; }
+    TF1*   GetFallOffFit() const    { return fFit; }
+    double GetTumourZ() const       { return fTumourZ; }
+    double GetTumourRadius() const  { return fTumourRadius; }
+    double GetTumourEdep() const    { return fTumourEdep; }
+    double GetHealthyEdep() const   { return fTotalEdep - fTumourEdep; }
+    double GetTotalEdep() const     { return fTotalEdep; }
+    double GetMaxEventEdep() const  { return fMaxEventEdep; }
+    std::int64_t GetNofEvents() const        { return fNofEvents; }
+    std::int64_t GetNofNonNullEvents() const { return fNofNonNullEvents; }
+    std::int64_t GetNofHits() const          { return fNofHits; }
+    std::int64_t GetNofOutOfRange() const    { return fNofOutOfRange; }
+
+  private:
+    EdMedPhDoseAnalysis(const EdMedPhDoseAnalysis&) = delete;
+    EdMedPhDoseAnalysis& operator=(const EdMedPhDoseAnalysis&) = delete;
+
+    // fine binning
+    double  fZMin;
+    double  fZWidth;
+    int     fNofZBins;
+    int     fNofRho2Bins;
+    double  fRho2Width;
+    std::vector<double>  fProfile;
+    std::vector<double>  fCore;        // fNofZBins x fNofRho2Bins
+
+    // streamed quantities
+    double  fTumourRadius;
+    float   fZLow;
+    float   fZHigh;
+    EdMedPhEventReducer  fEvents;
+    std::int64_t  fNofHits;
+    std::int64_t  fNofOutOfRange;
+
+    // results
+    TH1D*   fHZ;
+    TH1D*   fHDose;
+    TF1*    fFit;
+    double  fTumourZ;
+    double  fTumourEdep;
+    double  fTotalEdep;
+    double  fMaxEventEdep;
+    std::int64_t  fNofEvents;
+    std::int64_t  fNofNonNullEvents;
+};
+
+#endif
@@ -0,0 +1,90 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhEventReducer.hh
+/// \brief Definition of the EdMedPhEventReducer class
+
+#ifndef EdMedPhEventReducer_h
+#define EdMedPhEventReducer_h 1
+
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+/// Sums the energy deposits per event, keeping only the events with
+/// deposits.
+///
+/// The deposits of an event are consecutive in the ntuple of a 
+/// sequential run, so Add() keeps a running sum and emits the event 
+/// total when the EventID changes, to a list ordered by EventID. If an 
+/// EventID arrives out of order, as in the merged ntuple of a 
+/// multi-threaded run where the threads flush their events in blocks, 
+/// the reducer falls back to a hash map of the sums. Reducers of 
+/// consecutive parts of the ntuple are combined with Merge(), which 
+/// also joins events split across parts.
+
+class EdMedPhEventReducer
+{
+  public:
+    typedef std::pair<std::int32_t, double> EventSum;
+
+    EdMedPhEventReducer();
+
+    inline void Add(std::int32_t eventID, double edep);
+    void Merge(EdMedPhEventReducer& other);
+
+    // the events with deposits, ordered by EventID
+    const std::vector<EventSum>& GetEvents();
+
+    // the largest EventID seen, -1 if none
+    std::int32_t GetMaxEventID() const { return fMaxEventID; }
+    bool IsHashed() const { return fHashed; }
+
+  private:
+    void Flush();
+    void SwitchToHash();
+
+    std::int32_t  fCurrentID;
+    double        fCurrentSum;
+    std::int32_t  fMaxEventID;
+    bool          fHashed;
+    std::vector<EventSum>                    fEvents;
+    std::unordered_map<std::int32_t, double> fSums;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline void EdMedPhEventReducer::Add(std::int32_t eventID, double edep)
+{
+  if ( eventID != fCurrentID ) {
+    Flush();
+    fCurrentID = eventID;
+  }
+  fCurrentSum += edep;
+}
+
+#endif
@@ -0,0 +1,79 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhFileSet.hh
+/// \brief Definition of the EdMedPhFileSet class
+
+#ifndef EdMedPhFileSet_h
+#define EdMedPhFileSet_h 1
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/// Several output files read as one dataset, such as the thread files
+/// of an MT run written with /EdMedPh/output/mergeThreadFiles false and
+/// listed in <output>_manifest.csv.
+///
+/// The entries of the files are numbered one after the other; Split()
+/// cuts this global range into contiguous parts, each a list of ranges
+/// within single files, so that the threads of an analysis share the 
+/// files without any of them being merged first. No ROOT dependency.
+
+class EdMedPhFileSet
+{
+  public:
+    struct Range
+    {
+      std::size_t   file;
+      std::int64_t  first;
+      std::int64_t  last;
+    };
+
+    EdMedPhFileSet();
+
+    // the files of a manifest column ("root_file" or "hit_file"), with 
+    // the directory of the manifest
+    static std::vector<std::string> ReadManifest(
+      const std::string& manifestFileName, 
+      const std::string& column = "hit_file");
+
+    void Add(const std::string& fileName, std::int64_t nofEntries);
+
+    std::size_t GetNofFiles() const { return fFileNames.size(); }
+    const std::string& GetFileName(std::size_t i) const 
+                       { return fFileNames[i]; }
+    std::int64_t GetNofEntries() const { return fFirstEntries.back(); }
+
+    // the ranges of part (0 <= part < nofParts) of all the entries
+    std::vector<Range> Split(int part, int nofParts) const;
+
+  private:
+    std::vector<std::string>   fFileNames;
+    std::vector<std::int64_t>  fFirstEntries;  // one more than the files
+};
+
+#endif
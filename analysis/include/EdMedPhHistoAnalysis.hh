@@ -0,0 +1,69 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhHistoAnalysis.hh
+/// \brief Definition of the EdMedPhHistoAnalysis class
+
+#ifndef EdMedPhHistoAnalysis_h
+#define EdMedPhHistoAnalysis_h 1
+
+struct EdMedPhHitBlock;
+class TH2F;
+class TH3F;
+class TDirectory;
+
+/// The energy weighted maps of root_macros/make_histos.C: hXY, hZR and
+/// hZXY, in cm. Their binning is fixed, so that the histograms of 
+/// analyses filled from parts of the ntuple can be merged; the Z 
+/// profile and the energy per event of the macro are produced by 
+/// EdMedPhDoseAnalysis.
+
+class EdMedPhHistoAnalysis
+{
+  public:
+    EdMedPhHistoAnalysis(double zCut = 50.);
+    ~EdMedPhHistoAnalysis();
+
+    void Fill(const EdMedPhHitBlock& block);
+    void Merge(const EdMedPhHistoAnalysis& other);
+
+    // write hXY, hZR and hZXY to the given directory
+    void Write(TDirectory* directory) const;
+
+    TH2F* GetXYHistogram() const  { return fHXY; }
+    TH2F* GetZRHistogram() const  { return fHZR; }
+    TH3F* GetZXYHistogram() const { return fHZXY; }
+
+  private:
+    EdMedPhHistoAnalysis(const EdMedPhHistoAnalysis&) = delete;
+    EdMedPhHistoAnalysis& operator=(const EdMedPhHistoAnalysis&) = delete;
+
+    TH2F*  fHXY;
+    TH2F*  fHZR;
+    TH3F*  fHZXY;
+};
+
+#endif
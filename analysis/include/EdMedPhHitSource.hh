@@ -0,0 +1,95 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhHitSource.hh
+/// \brief Definition of the EdMedPhHitBlock and EdMedPhHitSource classes
+
+#ifndef EdMedPhHitSource_h
+#define EdMedPhHitSource_h 1
+
+#include <cstdint>
+#include <vector>
+
+/// A block of energy deposits of the EdMedPh ntuple, one array per 
+/// column. Positions are in mm with Z the depth from the calorimeter 
+/// entrance, energies in MeV, as written by the simulation.
+/// The arrays belong to the source that filled the block and stay valid
+/// until its next Next() call.
+
+struct EdMedPhHitBlock
+{
+  std::size_t          nofHits = 0;
+  const float*         edep = nullptr;
+  const float*         x = nullptr;
+  const float*         y = nullptr;
+  const float*         z = nullptr;
+  const std::int32_t*  eventID = nullptr;
+
+  std::size_t Size() const { return nofHits; }
+};
+
+/// Column storage for sources that decode the deposits, such as the
+/// ROOT ntuple, rather than pointing the block at their input.
+
+struct EdMedPhHitColumns
+{
+  std::vector<float>         edep;
+  std::vector<float>         x, y, z;
+  std::vector<std::int32_t>  eventID;
+
+  void Clear() 
+  { 
+    edep.clear(); x.clear(); y.clear(); z.clear(); eventID.clear(); 
+  }
+  void View(EdMedPhHitBlock& block) const
+  {
+    block.nofHits = edep.size();
+    block.edep = edep.data();
+    block.x = x.data();
+    block.y = y.data();
+    block.z = z.data();
+    block.eventID = eventID.data();
+  }
+};
+
+/// Sequential reader of energy deposits.
+///
+/// Next() points the block at the following deposits and returns false 
+/// once the source is exhausted. Analyses
+/// consume blocks so that they do not depend on the storage format.
+
+class EdMedPhHitSource
+{
+  public:
+    virtual ~EdMedPhHitSource() {}
+
+    virtual bool Next(EdMedPhHitBlock& block) = 0;
+
+    // number of deposits this source delivers in total
+    virtual std::int64_t GetNofHits() const = 0;
+};
+
+#endif
@@ -0,0 +1,67 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhPlotter.hh
+/// \brief Definition of the EdMedPhPlotter class
+
+#ifndef EdMedPhPlotter_h
+#define EdMedPhPlotter_h 1
+
+#include <string>
+#include <vector>
+
+class EdMedPhDataset;
+class TCanvas;
+
+/// The output stages of the ROOT macros run by script.sh, drawn from 
+/// analysed datasets rather than by re-reading the simulation output:
+/// - PlotDose:        analyse_dose.C, <particle>_hZ.pdf, _hDose.pdf
+///                    and _dose.root
+/// - PlotHistos:      make_histos.C, <particle>_hXY.pdf, _hZR.pdf, 
+///                    _hZXY.pdf and _histos.root
+/// - PlotEditedHisto: edit_histo.C, <particle>_edited_histo.pdf/.root
+/// - PlotSame:        plot_same.C, my_overplotted_histos.pdf
+/// ROOT graphics are not thread safe: the stages are run by one thread.
+
+class EdMedPhPlotter
+{
+  public:
+    EdMedPhPlotter(const std::string& outputDirectory = ".");
+    ~EdMedPhPlotter();
+
+    void PlotDose(const EdMedPhDataset& dataset);
+    void PlotHistos(const EdMedPhDataset& dataset);
+    void PlotEditedHisto(const EdMedPhDataset& dataset, double xMax);
+    void PlotSame(const std::vector<const EdMedPhDataset*>& datasets);
+
+  private:
+    std::string GetPath(const std::string& name) const;
+
+    std::string  fOutputDirectory;
+    TCanvas*     fCanvas;
+};
+
+#endif
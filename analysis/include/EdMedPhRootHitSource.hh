@@ -0,0 +1,79 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhRootHitSource.hh
+/// \brief Definition of the EdMedPhRootHitSource class
+
+#ifndef EdMedPhRootHitSource_h
+#define EdMedPhRootHitSource_h 1
+
+#include "EdMedPhHitSource.hh"
+
+#include <string>
+
+class TFile;
+class TTree;
+class TBranch;
+
+/// Reads the EdMedPh ntuple of a ROOT file written by the simulation.
+///
+/// Only the Edep, X, Y, Z and EventID branches are enabled, and each 
+/// branch is read directly rather than through TTree::GetEntry, with 
+/// a tree cache covering just those branches. The entry range 
+/// [first, last) can be restricted so that several sources share 
+/// one file.
+
+class EdMedPhRootHitSource : public EdMedPhHitSource
+{
+  public:
+    EdMedPhRootHitSource(const std::string& fileName, 
+                         std::int64_t first = 0, std::int64_t last = -1,
+                         std::size_t blockSize = 65536);
+    virtual ~EdMedPhRootHitSource();
+
+    virtual bool Next(EdMedPhHitBlock& block);
+    virtual std::int64_t GetNofHits() const { return fLast - fFirst; }
+
+    // number of entries of the whole ntuple
+    std::int64_t GetNofEntries() const;
+
+  private:
+    TBranch* Connect(const char* name, void* address);
+
+    TFile*        fFile;
+    TTree*        fTree;
+    TBranch*      fBranches[5];
+    std::int64_t  fFirst;
+    std::int64_t  fLast;
+    std::int64_t  fEntry;
+    std::size_t   fBlockSize;
+
+    float         fEdep, fX, fY, fZ;
+    std::int32_t  fEventID;
+    EdMedPhHitColumns  fColumns;
+};
+
+#endif
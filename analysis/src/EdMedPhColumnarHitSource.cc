@@ -0,0 +1,88 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhColumnarHitSource.cc
+/// \brief Implementation of the EdMedPhColumnarHitSource class
+
+#include "EdMedPhColumnarHitSource.hh"
+#include "EdMedPhColumnarReader.hh"
+
+#include <algorithm>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhColumnarHitSource::EdMedPhColumnarHitSource(
+                            const EdMedPhColumnarReader& reader,
+                            std::int64_t first, std::int64_t last)
+ : fReader(reader),
+   fFirst(first),
+   fLast(last),
+   fRow(first),
+   fChunk(0)
+{
+  auto nofRows = std::int64_t(fReader.GetNofRows());
+  if ( fLast < 0 || fLast > nofRows ) fLast = nofRows;
+  fFirst = std::max(std::int64_t(0), std::min(fFirst, fLast));
+  fRow = fFirst;
+  fChunk = fReader.FindChunk(fRow);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool EdMedPhColumnarHitSource::Next(EdMedPhHitBlock& block)
+{
+  block = EdMedPhHitBlock();
+  if ( fRow >= fLast || fChunk >= fReader.GetNofChunks() ) return false;
+
+  // the rest of the current chunk, up to the end of the range
+  const auto& chunk = fReader.GetChunk(fChunk);
+  auto offset = std::size_t(fRow - std::int64_t(chunk.firstRow));
+  auto end = std::min(fLast, std::int64_t(chunk.firstRow + chunk.nofRows));
+
+  if ( chunk.edep ) {
+    block.edep = chunk.edep;
+    block.x = chunk.x;
+    block.y = chunk.y;
+    block.z = chunk.z;
+    block.eventID = chunk.eventID;
+  }
+  else {
+    fReader.Decode(fChunk, fColumns);
+    fColumns.View(block);
+  }
+  block.nofHits = std::size_t(end - fRow);
+  block.edep += offset;
+  block.x += offset;
+  block.y += offset;
+  block.z += offset;
+  block.eventID += offset;
+
+  fRow = end;
+  ++fChunk;
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
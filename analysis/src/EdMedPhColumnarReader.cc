@@ -0,0 +1,182 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhColumnarReader.cc
+/// \brief Implementation of the EdMedPhColumnarReader class
+
+#include "EdMedPhColumnarReader.hh"
+#include "EdMedPhColumnarCodec.hh"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhColumnarReader::EdMedPhColumnarReader(const std::string& fileName)
+ : fFileName(fileName),
+   fMapping(nullptr),
+   fMappingSize(0),
+   fNofRows(0)
+{
+  auto fd = open(fileName.c_str(), O_RDONLY);
+  struct stat status;
+  if ( fd < 0 || fstat(fd, &status) != 0 ) {
+    if ( fd >= 0 ) close(fd);
+    throw std::runtime_error("Cannot open " + fileName);
+  }
+  if ( static_cast<std::size_t>(status.st_size) 
+         < sizeof(EdMedPhColumnarHeader) ) {
+    close(fd);
+    throw std::runtime_error(fileName + " is truncated");
+  }
+
+  fMappingSize = status.st_size;
+  fMapping = mmap(nullptr, fMappingSize, PROT_READ, MAP_SHARED, fd, 0);
+  close(fd);
+  if ( fMapping == MAP_FAILED ) {
+    fMapping = nullptr;
+    throw std::runtime_error("Cannot map " + fileName);
+  }
+
+  try {
+    Index();
+  }
+  catch ( ... ) {
+    munmap(fMapping, fMappingSize);
+    throw;
+  }
+
+  // scans go through the columns in file order
+  madvise(fMapping, fMappingSize, MADV_SEQUENTIAL);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhColumnarReader::~EdMedPhColumnarReader()
+{
+  if ( fMapping ) munmap(fMapping, fMappingSize);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhColumnarReader::Index()
+{
+  auto data = static_cast<const char*>(fMapping);
+  auto header = reinterpret_cast<const EdMedPhColumnarHeader*>(data);
+  if ( std::memcmp(header->magic, "EDMPCOL1", 8) != 0 ) {
+    throw std::runtime_error(fFileName + " is not a columnar hit file");
+  }
+  if ( header->nofColumns != EdMedPhColumnar::kNofColumns ) {
+    throw std::runtime_error(fFileName + " has unexpected columns");
+  }
+
+  // walk the chunk headers, checking each chunk against the file size
+  std::size_t offset = sizeof(EdMedPhColumnarHeader);
+  fChunks.reserve(header->nofChunks);
+  while ( offset < fMappingSize ) {
+    auto chunk = reinterpret_cast<const EdMedPhColumnarChunk*>(data + offset);
+    if ( fMappingSize - offset < sizeof(EdMedPhColumnarChunk) 
+         || fMappingSize - offset < EdMedPhColumnar::ChunkSize(*chunk) ) {
+      throw std::runtime_error(fFileName + " is truncated");
+    }
+    if ( chunk->codec == EdMedPhColumnar::kPackedZlib 
+         && ! EdMedPhColumnar::HasZlib() ) {
+      throw std::runtime_error(fFileName + 
+        " has zlib chunks, rebuild the reader with zlib");
+    }
+
+    EdMedPhColumnarChunkView view;
+    view.firstRow = fNofRows;
+    view.nofRows = chunk->nofRows;
+    view.header = chunk;
+    auto column = reinterpret_cast<const unsigned char*>(chunk + 1);
+    for ( int i = 0; i < EdMedPhColumnar::kNofColumns; ++i ) {
+      view.columns[i] = column;
+      column += EdMedPhColumnar::ColumnSize(*chunk, i);
+    }
+    auto isRaw = ( chunk->codec == EdMedPhColumnar::kRaw );
+    view.edep = isRaw ? reinterpret_cast<const float*>(
+                  view.columns[EdMedPhColumnar::kEdep]) : nullptr;
+    view.x = isRaw ? reinterpret_cast<const float*>(
+               view.columns[EdMedPhColumnar::kX]) : nullptr;
+    view.y = isRaw ? reinterpret_cast<const float*>(
+               view.columns[EdMedPhColumnar::kY]) : nullptr;
+    view.z = isRaw ? reinterpret_cast<const float*>(
+               view.columns[EdMedPhColumnar::kZ]) : nullptr;
+    view.eventID = isRaw ? reinterpret_cast<const std::int32_t*>(
+                     view.columns[EdMedPhColumnar::kEventID]) : nullptr;
+    fChunks.push_back(view);
+
+    fNofRows += chunk->nofRows;
+    offset += EdMedPhColumnar::ChunkSize(*chunk);
+  }
+
+  if ( fChunks.size() != header->nofChunks || fNofRows != header->nofRows ) {
+    throw std::runtime_error(fFileName + 
+      " does not match its header, was the run closed?");
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::size_t EdMedPhColumnarReader::FindChunk(std::uint64_t row) const
+{
+  if ( row >= fNofRows ) return fChunks.size();
+
+  // the last chunk starting at or before the row
+  auto chunk = std::upper_bound(fChunks.begin(), fChunks.end(), row,
+    [](std::uint64_t value, const EdMedPhColumnarChunkView& view) 
+      { return value < view.firstRow; });
+  return std::size_t(chunk - fChunks.begin()) - 1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhColumnarReader::Decode(std::size_t i, 
+                                   EdMedPhHitColumns& columns) const
+{
+  const auto& view = fChunks[i];
+  columns.edep.resize(view.nofRows);
+  columns.x.resize(view.nofRows);
+  columns.y.resize(view.nofRows);
+  columns.z.resize(view.nofRows);
+  columns.eventID.resize(view.nofRows);
+  if ( ! EdMedPhColumnar::DecodeChunk(*view.header, view.columns,
+                                      columns.edep.data(), columns.x.data(),
+                                      columns.y.data(), columns.z.data(),
+                                      columns.eventID.data()) ) {
+    throw std::runtime_error("Corrupt chunk " + std::to_string(i) + 
+                             " in " + fFileName);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,181 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhDataset.cc
+/// \brief Implementation of the EdMedPhDataset class
+
+#include "EdMedPhDataset.hh"
+#include "EdMedPhDoseAnalysis.hh"
+#include "EdMedPhHistoAnalysis.hh"
+#include "EdMedPhRootHitSource.hh"
+#include "EdMedPhColumnarHitSource.hh"
+#include "EdMedPhColumnarReader.hh"
+
+#include "TFile.h"
+#include "TTree.h"
+#include "TH1D.h"
+
+#include <algorithm>
+#include <chrono>
+#include <exception>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+  // the analyses of one part of the ntuple
+  struct Part
+  {
+    std::unique_ptr<EdMedPhDoseAnalysis>   dose;
+    std::unique_ptr<EdMedPhHistoAnalysis>  histos;
+    std::exception_ptr                     error;
+  };
+
+  typedef std::vector<std::unique_ptr<EdMedPhColumnarReader>> Readers;
+
+  void AnalysePart(const EdMedPhFileSet& hitFiles, const Readers& readers,
+                   int index, int nofParts, Part& part)
+  {
+    try {
+      for ( const auto& range : hitFiles.Split(index, nofParts) ) {
+        std::unique_ptr<EdMedPhHitSource> source;
+        const auto& reader = readers[range.file];
+        if ( reader ) {
+          source.reset(new EdMedPhColumnarHitSource(
+                             *reader, range.first, range.last));
+        }
+        else {
+          source.reset(new EdMedPhRootHitSource(
+                             hitFiles.GetFileName(range.file), 
+                             range.first, range.last));
+        }
+        EdMedPhHitBlock block;
+        while ( source->Next(block) ) {
+          part.dose->Fill(block);
+          part.histos->Fill(block);
+        }
+      }
+    }
+    catch ( ... ) {
+      part.error = std::current_exception();
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhDataset::EdMedPhDataset(const std::string& particle, 
+                               const std::string& fileName,
+                               const std::vector<std::string>& hitFileNames)
+ : fParticle(particle),
+   fFileName(fileName),
+   fNofEntries(0),
+   fNofThreads(0),
+   fElapsedTime(0.),
+   fEdepVsZ(nullptr)
+{
+  // the deposits, by default from the ntuple of the ROOT file
+  auto names = hitFileNames;
+  if ( names.empty() ) names.push_back(fileName);
+  for ( const auto& name : names ) {
+    if ( name.find(".edmc") != std::string::npos ) {
+      fHitReaders.emplace_back(new EdMedPhColumnarReader(name));
+      fHitFiles.Add(name, std::int64_t(fHitReaders.back()->GetNofRows()));
+      continue;
+    }
+    std::unique_ptr<TFile> file(TFile::Open(name.c_str()));
+    if ( ! file || file->IsZombie() ) {
+      throw std::runtime_error("Cannot open " + name);
+    }
+    auto tree = dynamic_cast<TTree*>(file->Get("EdMedPh"));
+    if ( ! tree ) {
+      throw std::runtime_error("No EdMedPh ntuple in " + name);
+    }
+    fHitReaders.emplace_back(nullptr);
+    fHitFiles.Add(name, tree->GetEntries());
+  }
+  fNofEntries = fHitFiles.GetNofEntries();
+
+  // the histogram of the run, merged over the threads
+  std::unique_ptr<TFile> file(TFile::Open(fileName.c_str()));
+  if ( ! file || file->IsZombie() ) return;
+
+  auto edepVsZ = dynamic_cast<TH1D*>(file->Get("Edep_vs_z"));
+  if ( edepVsZ ) {
+    fEdepVsZ = static_cast<TH1D*>(edepVsZ->Clone());
+    fEdepVsZ->SetDirectory(nullptr);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhDataset::~EdMedPhDataset()
+{
+  delete fEdepVsZ;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhDataset::Analyse(int nofThreads, double tumourRadius,
+                             double zMax, double zWidth)
+{
+  auto start = std::chrono::steady_clock::now();
+
+  fNofThreads = int(std::max(std::int64_t(1), 
+                             std::min(std::int64_t(nofThreads), fNofEntries)));
+
+  std::vector<Part> parts(fNofThreads);
+  for ( auto& part : parts ) {
+    part.dose.reset(new EdMedPhDoseAnalysis(tumourRadius, 0., zMax, zWidth));
+    part.histos.reset(new EdMedPhHistoAnalysis);
+  }
+
+  std::vector<std::thread> threads;
+  for ( int i = 0; i < fNofThreads; ++i ) {
+    threads.emplace_back(AnalysePart, std::cref(fHitFiles), 
+                         std::cref(fHitReaders), i, fNofThreads, 
+                         std::ref(parts[i]));
+  }
+  for ( auto& thread : threads ) thread.join();
+
+  for ( auto& part : parts ) {
+    if ( part.error ) std::rethrow_exception(part.error);
+  }
+  for ( int i = 1; i < fNofThreads; ++i ) {
+    parts[0].dose->Merge(*parts[i].dose);
+    parts[0].histos->Merge(*parts[i].histos);
+  }
+  parts[0].dose->Finish();
+
+  fDose = std::move(parts[0].dose);
+  fHistos = std::move(parts[0].histos);
+
+  std::chrono::duration<double> elapsed 
+    = std::chrono::steady_clock::now() - start;
+  fElapsedTime = elapsed.count();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,251 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhDoseAnalysis.cc
+/// \brief Implementation of the EdMedPhDoseAnalysis class
+
+#include "EdMedPhDoseAnalysis.hh"
+#include "EdMedPhHitSource.hh"
+
+#include "TH1D.h"
+#include "TF1.h"
+#include "TDirectory.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+
+namespace {
+  // TF1 registration and the default minimiser are not thread safe
+  std::mutex fitMutex;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhDoseAnalysis::EdMedPhDoseAnalysis(double tumourRadius,
+                                         double zMin, double zMax, 
+                                         double zWidth, int nofRho2Bins)
+ : fZMin(zMin),
+   fZWidth(zWidth),
+   fNofZBins(int(std::ceil((zMax - zMin)/zWidth))),
+   fNofRho2Bins(nofRho2Bins),
+   fRho2Width(tumourRadius*tumourRadius/nofRho2Bins),
+   fTumourRadius(tumourRadius),
+   fZLow(std::numeric_limits<float>::max()),
+   fZHigh(std::numeric_limits<float>::lowest()),
+   fNofHits(0),
+   fNofOutOfRange(0),
+   fHZ(nullptr),
+   fHDose(nullptr),
+   fFit(nullptr),
+   fTumourZ(0.),
+   fTumourEdep(0.),
+   fTotalEdep(0.),
+   fMaxEventEdep(0.),
+   fNofEvents(0),
+   fNofNonNullEvents(0)
+{
+  if ( fNofZBins <= 0 || nofRho2Bins <= 0 || tumourRadius <= 0. ) {
+    throw std::invalid_argument("EdMedPhDoseAnalysis: empty binning");
+  }
+  fProfile.assign(fNofZBins, 0.);
+  fCore.assign(std::size_t(fNofZBins)*fNofRho2Bins, 0.);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhDoseAnalysis::~EdMedPhDoseAnalysis()
+{
+  delete fFit;
+  delete fHDose;
+  delete fHZ;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhDoseAnalysis::Fill(const EdMedPhHitBlock& block)
+{
+  auto radius2 = fTumourRadius*fTumourRadius;
+
+  for ( std::size_t i = 0; i < block.Size(); ++i ) {
+    auto edep = block.edep[i];
+    auto z = block.z[i];
+    auto eventID = block.eventID[i];
+
+    // energy per event
+    if ( eventID < 0 ) {
+      throw std::runtime_error("EdMedPhDoseAnalysis: negative EventID");
+    }
+    fEvents.Add(eventID, edep);
+
+    // Z range for the final binning
+    fZLow = std::min(fZLow, z);
+    fZHigh = std::max(fZHigh, z);
+
+    // fine profile along Z
+    auto iz = int(std::floor((z - fZMin)/fZWidth));
+    if ( iz < 0 || iz >= fNofZBins ) {
+      ++fNofOutOfRange;
+      continue;
+    }
+    fProfile[iz] += edep;
+
+    // cells around the beam axis, for the tumour sphere
+    auto rho2 = double(block.x[i])*block.x[i] + double(block.y[i])*block.y[i];
+    if ( rho2 < radius2 ) {
+      auto ir = int(rho2/fRho2Width);
+      fCore[std::size_t(iz)*fNofRho2Bins + ir] += edep;
+    }
+  }
+  fNofHits += block.Size();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhDoseAnalysis::Merge(EdMedPhDoseAnalysis& other)
+{
+  if ( other.fNofZBins != fNofZBins || other.fNofRho2Bins != fNofRho2Bins 
+       || other.fZMin != fZMin || other.fZWidth != fZWidth
+       || other.fTumourRadius != fTumourRadius ) {
+    throw std::invalid_argument("EdMedPhDoseAnalysis: cannot merge analyses"
+                                " with different binnings");
+  }
+
+  for ( std::size_t i = 0; i < fProfile.size(); ++i ) {
+    fProfile[i] += other.fProfile[i];
+  }
+  for ( std::size_t i = 0; i < fCore.size(); ++i ) {
+    fCore[i] += other.fCore[i];
+  }
+
+  fZLow = std::min(fZLow, other.fZLow);
+  fZHigh = std::max(fZHigh, other.fZHigh);
+
+  fEvents.Merge(other.fEvents);
+
+  fNofHits += other.fNofHits;
+  fNofOutOfRange += other.fNofOutOfRange;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhDoseAnalysis::Finish()
+{
+  delete fFit;
+  delete fHDose;
+  delete fHZ;
+  fFit = nullptr;
+  fHDose = nullptr;
+  fHZ = nullptr;
+
+  if ( fNofHits == 0 ) {
+    throw std::runtime_error("EdMedPhDoseAnalysis: no energy deposit");
+  }
+
+  // hZ with the binning of analyse_dose.C: 101 bins centred on the 
+  // extreme Z values, in cm, filled from the fine profile
+  auto nBins = 100;
+  auto zMin = fZLow/10.;
+  auto zMax = fZHigh/10.;
+  auto halfBinWidth = (zMax - zMin)/(2.*nBins);
+  zMin -= halfBinWidth;
+  zMax += halfBinWidth;
+  nBins++;
+
+  fHZ = new TH1D("hZ", "Deposited Energy; Z (cm) ; Deposited Energy (MeV)",
+                 nBins, zMin, zMax);
+  fHZ->SetDirectory(nullptr);
+  for ( int iz = 0; iz < fNofZBins; ++iz ) {
+    if ( fProfile[iz] == 0. ) continue;
+    auto z = std::min(std::max(fZMin + (iz + 0.5)*fZWidth, double(fZLow)),
+                      double(fZHigh));
+    fHZ->Fill(z/10., fProfile[iz]);
+  }
+
+  // The tumour is centred on the bin with the maximum energy
+  auto binMax = fHZ->GetMaximumBin();
+  fTumourZ = fHZ->GetXaxis()->GetBinCenter(binMax)*10.;
+
+  // Energy in the sphere from the (Z, R^2) cells whose centre is inside
+  fTumourEdep = 0.;
+  auto radius2 = fTumourRadius*fTumourRadius;
+  auto izFirst = std::max(0, 
+    int(std::floor((fTumourZ - fTumourRadius - fZMin)/fZWidth)));
+  auto izLast = std::min(fNofZBins - 1, 
+    int(std::floor((fTumourZ + fTumourRadius - fZMin)/fZWidth)));
+  for ( int iz = izFirst; iz <= izLast; ++iz ) {
+    auto dz = fZMin + (iz + 0.5)*fZWidth - fTumourZ;
+    auto row = &fCore[std::size_t(iz)*fNofRho2Bins];
+    for ( int ir = 0; ir < fNofRho2Bins; ++ir ) {
+      if ( (ir + 0.5)*fRho2Width + dz*dz > radius2 ) break;
+      fTumourEdep += row[ir];
+    }
+  }
+
+  // Energy per event, of the events with deposits only; the event count
+  // follows the macro, from the largest EventID
+  const auto& events = fEvents.GetEvents();
+  fNofEvents = fEvents.GetMaxEventID() + 1;
+  fTotalEdep = 0.;
+  fMaxEventEdep = 0.;
+  fNofNonNullEvents = 0;
+  for ( const auto& event : events ) {
+    fTotalEdep += event.second;
+    fMaxEventEdep = std::max(fMaxEventEdep, event.second);
+  }
+
+  auto nDoseBins = std::max(int(fMaxEventEdep)*2, 1);
+  fHDose = new TH1D("hDose", ";Deposited Energy (MeV);Counts",
+                    nDoseBins, 0., fMaxEventEdep);
+  fHDose->SetDirectory(nullptr);
+  for ( const auto& event : events ) {
+    if ( event.second > 0. ) {
+      ++fNofNonNullEvents;
+      fHDose->Fill(event.second);
+    }
+  }
+
+  // Exponential fall off beyond the peak
+  std::lock_guard<std::mutex> lock(fitMutex);
+  auto xMax = fTumourZ/10.;
+  fFit = new TF1("m1", "expo", xMax + 2., 50.);
+  fHZ->Fit(fFit, "RQ0");
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhDoseAnalysis::Write(TDirectory* directory) const
+{
+  if ( ! fHZ ) return;
+
+  directory->cd();
+  fHZ->Write();
+  fHDose->Write();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,128 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhEventReducer.cc
+/// \brief Implementation of the EdMedPhEventReducer class
+
+#include "EdMedPhEventReducer.hh"
+
+#include <algorithm>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhEventReducer::EdMedPhEventReducer()
+ : fCurrentID(-1),
+   fCurrentSum(0.),
+   fMaxEventID(-1),
+   fHashed(false)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhEventReducer::Flush()
+{
+  if ( fCurrentID < 0 ) return;
+
+  if ( ! fHashed && ! fEvents.empty() && fCurrentID <= fEvents.back().first ) {
+    SwitchToHash();
+  }
+  if ( fHashed ) {
+    fSums[fCurrentID] += fCurrentSum;
+  }
+  else {
+    fEvents.emplace_back(fCurrentID, fCurrentSum);
+  }
+  fMaxEventID = std::max(fMaxEventID, fCurrentID);
+
+  fCurrentID = -1;
+  fCurrentSum = 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhEventReducer::SwitchToHash()
+{
+  fSums.reserve(2*fEvents.size());
+  for ( const auto& event : fEvents ) fSums[event.first] += event.second;
+  fEvents.clear();
+  fEvents.shrink_to_fit();
+  fHashed = true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhEventReducer::Merge(EdMedPhEventReducer& other)
+{
+  Flush();
+  other.Flush();
+
+  if ( fHashed || other.fHashed ) {
+    if ( ! fHashed ) SwitchToHash();
+    for ( const auto& event : other.fEvents ) fSums[event.first] += event.second;
+    for ( const auto& sum : other.fSums ) fSums[sum.first] += sum.second;
+  }
+  else {
+    // both ordered: merge them, summing the events split between parts
+    std::vector<EventSum> events;
+    events.reserve(fEvents.size() + other.fEvents.size());
+    auto a = fEvents.begin();
+    auto b = other.fEvents.begin();
+    while ( a != fEvents.end() || b != other.fEvents.end() ) {
+      if ( b == other.fEvents.end() 
+           || ( a != fEvents.end() && a->first < b->first ) ) {
+        events.push_back(*a++);
+      }
+      else if ( a == fEvents.end() || b->first < a->first ) {
+        events.push_back(*b++);
+      }
+      else {
+        events.emplace_back(a->first, a->second + b->second);
+        ++a;
+        ++b;
+      }
+    }
+    fEvents.swap(events);
+  }
+  fMaxEventID = std::max(fMaxEventID, other.fMaxEventID);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+const std::vector<EdMedPhEventReducer::EventSum>& 
+EdMedPhEventReducer::GetEvents()
+{
+  Flush();
+
+  if ( fHashed ) {
+    fEvents.assign(fSums.begin(), fSums.end());
+    std::sort(fEvents.begin(), fEvents.end());
+    fSums.clear();
+    fHashed = false;
+  }
+  return fEvents;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,117 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhFileSet.cc
+/// \brief Implementation of the EdMedPhFileSet class
+
+#include "EdMedPhFileSet.hh"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+  std::vector<std::string> SplitLine(const std::string& line)
+  {
+    std::vector<std::string> fields;
+    std::istringstream stream(line);
+    std::string field;
+    while ( std::getline(stream, field, ',') ) fields.push_back(field);
+    return fields;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhFileSet::EdMedPhFileSet()
+ : fFirstEntries(1, 0)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::vector<std::string> EdMedPhFileSet::ReadManifest(
+                           const std::string& manifestFileName,
+                           const std::string& column)
+{
+  std::ifstream manifest(manifestFileName);
+  std::string line;
+  if ( ! manifest || ! std::getline(manifest, line) ) {
+    throw std::runtime_error("Cannot read " + manifestFileName);
+  }
+  auto header = SplitLine(line);
+  auto index = std::size_t(
+    std::find(header.begin(), header.end(), column) - header.begin());
+  if ( index == header.size() ) {
+    throw std::runtime_error("No " + column + " in " + manifestFileName);
+  }
+
+  // the files are relative to the manifest
+  auto slash = manifestFileName.rfind('/');
+  auto directory = ( slash == std::string::npos ) 
+    ? std::string() : manifestFileName.substr(0, slash + 1);
+
+  std::vector<std::string> fileNames;
+  while ( std::getline(manifest, line) ) {
+    auto fields = SplitLine(line);
+    if ( fields.size() <= index || fields[index].empty() ) {
+      throw std::runtime_error("No " + column + " for a thread in " 
+                               + manifestFileName);
+    }
+    fileNames.push_back(directory + fields[index]);
+  }
+  return fileNames;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhFileSet::Add(const std::string& fileName, std::int64_t nofEntries)
+{
+  fFileNames.push_back(fileName);
+  fFirstEntries.push_back(fFirstEntries.back() + nofEntries);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::vector<EdMedPhFileSet::Range> EdMedPhFileSet::Split(int part, 
+                                                         int nofParts) const
+{
+  auto nofEntries = GetNofEntries();
+  auto first = nofEntries*part/nofParts;
+  auto last = nofEntries*(part + 1)/nofParts;
+
+  std::vector<Range> ranges;
+  for ( std::size_t i = 0; i < fFileNames.size(); ++i ) {
+    auto begin = std::max(first, fFirstEntries[i]);
+    auto end = std::min(last, fFirstEntries[i+1]);
+    if ( begin < end ) {
+      ranges.push_back({ i, begin - fFirstEntries[i], end - fFirstEntries[i] });
+    }
+  }
+  return ranges;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,103 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhHistoAnalysis.cc
+/// \brief Implementation of the EdMedPhHistoAnalysis class
+
+#include "EdMedPhHistoAnalysis.hh"
+#include "EdMedPhHitSource.hh"
+
+#include "TH2F.h"
+#include "TH3F.h"
+#include "TDirectory.h"
+
+#include <cmath>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhHistoAnalysis::EdMedPhHistoAnalysis(double zCut)
+ : fHXY(nullptr),
+   fHZR(nullptr),
+   fHZXY(nullptr)
+{
+  fHXY = new TH2F("hXY", "; X (cm) ; Y (cm)",
+                  100, -15.0, 15.0, 100, -15.0, 15.0);
+  fHZR = new TH2F("hZR", "; Z (cm) ; R (cm)",
+                  100, 0.0, 15.0, 100, 0.0, 5.0);
+  fHZXY = new TH3F("hZXY", "; Z (cm) ; X (cm); Y (cm)",
+                   50, 0., zCut, 32, -15.0, 15.0, 32, -15.0, 15.0);
+
+  // owned here rather than by the current ROOT directory
+  fHXY->SetDirectory(nullptr);
+  fHZR->SetDirectory(nullptr);
+  fHZXY->SetDirectory(nullptr);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhHistoAnalysis::~EdMedPhHistoAnalysis()
+{
+  delete fHZXY;
+  delete fHZR;
+  delete fHXY;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhHistoAnalysis::Fill(const EdMedPhHitBlock& block)
+{
+  for ( std::size_t i = 0; i < block.Size(); ++i ) {
+    auto edep = block.edep[i];
+    auto x = block.x[i]/10.;
+    auto y = block.y[i]/10.;
+    auto z = block.z[i]/10.;
+
+    fHXY->Fill(x, y, edep);
+    fHZR->Fill(z, std::sqrt(x*x + y*y), edep);
+    fHZXY->Fill(z, x, y, edep);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhHistoAnalysis::Merge(const EdMedPhHistoAnalysis& other)
+{
+  fHXY->Add(other.fHXY);
+  fHZR->Add(other.fHZR);
+  fHZXY->Add(other.fHZXY);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhHistoAnalysis::Write(TDirectory* directory) const
+{
+  directory->cd();
+  fHXY->Write();
+  fHZR->Write();
+  fHZXY->Write();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
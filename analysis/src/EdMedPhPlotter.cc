@@ -0,0 +1,241 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhPlotter.cc
+/// \brief Implementation of the EdMedPhPlotter class
+
+#include "EdMedPhPlotter.hh"
+#include "EdMedPhDataset.hh"
+#include "EdMedPhDoseAnalysis.hh"
+#include "EdMedPhHistoAnalysis.hh"
+
+#include "TROOT.h"
+#include "TStyle.h"
+#include "TCanvas.h"
+#include "TFrame.h"
+#include "TFile.h"
+#include "TF1.h"
+#include "TH1D.h"
+#include "TH2F.h"
+#include "TH3F.h"
+#include "TGaxis.h"
+#include "TGraphErrors.h"
+#include "TEllipse.h"
+#include "TColor.h"
+
+#include <cmath>
+#include <memory>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhPlotter::EdMedPhPlotter(const std::string& outputDirectory)
+ : fOutputDirectory(outputDirectory),
+   fCanvas(nullptr)
+{
+  gROOT->SetBatch(true);
+  fCanvas = new TCanvas("canvas", "canvas");
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhPlotter::~EdMedPhPlotter()
+{
+  delete fCanvas;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::string EdMedPhPlotter::GetPath(const std::string& name) const
+{
+  return fOutputDirectory + "/" + name;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhPlotter::PlotDose(const EdMedPhDataset& dataset)
+{
+  const auto& particle = dataset.GetParticle();
+  auto dose = dataset.GetDose();
+  auto hZ = dose->GetZHistogram();
+  auto fit = dose->GetFallOffFit();
+  auto zTumour = dose->GetTumourZ()/10.;
+  auto tumourRadius = dose->GetTumourRadius()/10.;
+
+  gROOT->SetStyle("ATLAS");
+  gROOT->ForceStyle();
+  gStyle->SetMarkerSize(0.2);
+  TGaxis::SetMaxDigits(2);
+  fCanvas->Clear();
+  fCanvas->SetLogz(0);
+
+  hZ->Draw("hist");
+  fit->SetLineStyle(9);
+  fit->SetLineColor(46);
+  fit->SetTitle(Form("#splitline{Fit to exponential decrease}"
+                     "{exp(%5.2f-%5.2f z)}", 
+                     fit->GetParameter(0), std::abs(fit->GetParameter(1))));
+  fit->Draw("same");
+
+  // the tumour extent along Z
+  fCanvas->Update();
+  auto histTop = fCanvas->GetFrame()->GetY2();
+  double xv[] = { zTumour, zTumour };
+  double yv[] = { histTop/4, histTop*3/4 };
+  double exv[] = { tumourRadius, tumourRadius };
+  double eyv[] = { histTop/4, histTop/4 };
+  TGraphErrors tumourRange(2, xv, yv, exv, eyv);
+  tumourRange.SetFillStyle(3351);
+  tumourRange.SetFillColor(35);
+  tumourRange.SetTitle("Range of tumour");
+  tumourRange.Draw("same2");
+
+  fCanvas->BuildLegend();
+  gStyle->SetOptStat(1000010);
+  fCanvas->SaveAs(GetPath(particle + "_hZ.pdf").c_str());
+
+  fCanvas->Clear();
+  dose->GetDoseHistogram()->Draw("hist");
+  fCanvas->SaveAs(GetPath(particle + "_hDose.pdf").c_str());
+
+  TFile outputFile(GetPath(particle + "_dose.root").c_str(), "RECREATE");
+  dose->Write(&outputFile);
+  outputFile.Close();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhPlotter::PlotHistos(const EdMedPhDataset& dataset)
+{
+  const auto& particle = dataset.GetParticle();
+  auto histos = dataset.GetHistos();
+  auto zTumour = dataset.GetDose()->GetTumourZ()/10.;
+  auto tumourRadius = dataset.GetDose()->GetTumourRadius()/10.;
+
+  gROOT->SetStyle("Modern");
+  gROOT->ForceStyle();
+  gStyle->SetMarkerSize(0.2);
+  TGaxis::SetMaxDigits(2);
+  fCanvas->Clear();
+  fCanvas->SetLogz();
+
+  TEllipse tumourXY(0, 0, tumourRadius, tumourRadius);
+  TEllipse tumourZR(zTumour, 0, tumourRadius, tumourRadius, 0, 180);
+  for ( auto tumour : { &tumourXY, &tumourZR } ) {
+    tumour->SetFillColorAlpha(0, 0);
+    tumour->SetLineWidth(3);
+    tumour->SetLineColor(2);
+  }
+
+  histos->GetXYHistogram()->Draw("colz");
+  tumourXY.Draw("same");
+  fCanvas->Update();
+  fCanvas->SaveAs(GetPath(particle + "_hXY.pdf").c_str());
+
+  histos->GetZRHistogram()->Draw("colz");
+  tumourZR.Draw("same");
+  fCanvas->Update();
+  fCanvas->SaveAs(GetPath(particle + "_hZR.pdf").c_str());
+
+  fCanvas->SetLogz(0);
+  auto hZXY = histos->GetZXYHistogram();
+  hZXY->SetFillColor(29);
+  hZXY->Draw();
+  hZXY->Draw("sameISO");
+  fCanvas->Update();
+  fCanvas->SaveAs(GetPath(particle + "_hZXY.pdf").c_str());
+
+  TFile outputFile(GetPath(particle + "_histos.root").c_str(), "RECREATE");
+  histos->Write(&outputFile);
+  outputFile.Close();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhPlotter::PlotEditedHisto(const EdMedPhDataset& dataset, 
+                                     double xMax)
+{
+  if ( ! dataset.GetEdepVsZ() ) return;
+
+  const auto& particle = dataset.GetParticle();
+  std::unique_ptr<TH1D> edepVsZ(
+    static_cast<TH1D*>(dataset.GetEdepVsZ()->Clone("Edep_vs_Z")));
+  edepVsZ->SetDirectory(nullptr);
+  edepVsZ->SetTitle(";Z in phantom (mm);Accumulated energy deposited (MeV)");
+  // in mm, the range applies to the pdf only
+  edepVsZ->GetXaxis()->SetRangeUser(-5, xMax*10.);
+
+  gROOT->SetStyle("ATLAS");
+  gROOT->ForceStyle();
+  gStyle->SetMarkerSize(0.2);
+  gStyle->SetOptStat(0);
+  gStyle->SetOptTitle(0);
+  TGaxis::SetMaxDigits(2);
+  fCanvas->Clear();
+  fCanvas->SetLogz(0);
+
+  edepVsZ->Draw("hist");
+  fCanvas->SaveAs(GetPath(particle + "_edited_histo.pdf").c_str());
+  edepVsZ->SaveAs(GetPath(particle + "_edited_histo.root").c_str());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhPlotter::PlotSame(
+                       const std::vector<const EdMedPhDataset*>& datasets)
+{
+  const int colors[] = { kRed, kBlue, kGreen+2, kMagenta, kOrange+7 };
+
+  gROOT->SetStyle("ATLAS");
+  gROOT->ForceStyle();
+  gStyle->SetMarkerSize(0.2);
+  gStyle->SetOptStat(0);
+  gStyle->SetOptTitle(0);
+
+  // long and thin
+  TCanvas canvas("overlay", "overlay", 800, 400);
+
+  std::vector<std::unique_ptr<TH1D>> histograms;
+  for ( auto dataset : datasets ) {
+    if ( ! dataset->GetEdepVsZ() ) continue;
+    auto name = "Edep_vs_Z_" + dataset->GetParticle();
+    histograms.emplace_back(
+      static_cast<TH1D*>(dataset->GetEdepVsZ()->Clone(name.c_str())));
+
+    // normalised to the integral of energy
+    auto histogram = histograms.back().get();
+    histogram->SetDirectory(nullptr);
+    histogram->SetTitle(
+      ";Z in phantom (mm);Relative energy deposited (arbitrary units)");
+    histogram->Scale(1./histogram->Integral());
+    histogram->SetLineColor(colors[(histograms.size() - 1) % 5]);
+    histogram->Draw(histograms.size() == 1 ? "hist" : "hist SAME");
+  }
+  if ( histograms.size() < 2 ) return;
+
+  canvas.SaveAs(GetPath("my_overplotted_histos.pdf").c_str());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
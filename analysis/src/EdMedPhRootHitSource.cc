@@ -0,0 +1,138 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhRootHitSource.cc
+/// \brief Implementation of the EdMedPhRootHitSource class
+
+#include "EdMedPhRootHitSource.hh"
+
+#include "TFile.h"
+#include "TTree.h"
+#include "TBranch.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhRootHitSource::EdMedPhRootHitSource(const std::string& fileName,
+                                           std::int64_t first, 
+                                           std::int64_t last,
+                                           std::size_t blockSize)
+ : fFile(nullptr),
+   fTree(nullptr),
+   fFirst(first),
+   fLast(last),
+   fEntry(first),
+   fBlockSize(blockSize),
+   fEdep(0.), fX(0.), fY(0.), fZ(0.),
+   fEventID(0)
+{
+  fFile = TFile::Open(fileName.c_str());
+  if ( ! fFile || fFile->IsZombie() ) {
+    delete fFile;
+    throw std::runtime_error("Cannot open " + fileName);
+  }
+  fTree = dynamic_cast<TTree*>(fFile->Get("EdMedPh"));
+  if ( ! fTree ) {
+    delete fFile;
+    throw std::runtime_error("No EdMedPh ntuple in " + fileName);
+  }
+
+  // The ntuple columns are floats and an int (see EdMedPhRunAction)
+  fTree->SetBranchStatus("*", false);
+  fBranches[0] = Connect("Edep", &fEdep);
+  fBranches[1] = Connect("X", &fX);
+  fBranches[2] = Connect("Y", &fY);
+  fBranches[3] = Connect("Z", &fZ);
+  fBranches[4] = Connect("EventID", &fEventID);
+
+  auto nofEntries = fTree->GetEntries();
+  if ( fLast < 0 || fLast > nofEntries ) fLast = nofEntries;
+  fFirst = std::min(fFirst, fLast);
+  fEntry = fFirst;
+
+  // Prefetch the baskets of the enabled branches over our range only
+  fTree->SetCacheSize(64*1024*1024);
+  for ( auto branch : fBranches ) fTree->AddBranchToCache(branch, true);
+  fTree->SetCacheEntryRange(fFirst, fLast);
+  fTree->StopCacheLearningPhase();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhRootHitSource::~EdMedPhRootHitSource()
+{
+  // the tree is owned by the file
+  delete fFile;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+TBranch* EdMedPhRootHitSource::Connect(const char* name, void* address)
+{
+  auto branch = fTree->GetBranch(name);
+  if ( ! branch ) {
+    throw std::runtime_error(std::string("No branch ") + name 
+                             + " in the EdMedPh ntuple");
+  }
+  fTree->SetBranchStatus(name, true);
+  branch->SetAddress(address);
+  return branch;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::int64_t EdMedPhRootHitSource::GetNofEntries() const
+{
+  return fTree->GetEntries();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+bool EdMedPhRootHitSource::Next(EdMedPhHitBlock& block)
+{
+  fColumns.Clear();
+  fColumns.View(block);
+  if ( fEntry >= fLast ) return false;
+
+  auto end = std::min(fLast, fEntry + std::int64_t(fBlockSize));
+  for ( ; fEntry < end; ++fEntry ) {
+    // the cache needs the tree entry number to be set
+    auto local = fTree->LoadTree(fEntry);
+    for ( auto branch : fBranches ) branch->GetEntry(local);
+
+    fColumns.edep.push_back(fEdep);
+    fColumns.x.push_back(fX);
+    fColumns.y.push_back(fY);
+    fColumns.z.push_back(fZ);
+    fColumns.eventID.push_back(fEventID);
+  }
+  fColumns.View(block);
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
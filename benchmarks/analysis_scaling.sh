@@ -0,0 +1,31 @@
+#!/bin/bash
+# Scaling of the compiled analysis with the number of threads:
+# wall time, speed up and parallel efficiency relative to one thread.
+#
+# Usage: benchmarks/analysis_scaling.sh [analysis] [particle] [max threads]
+# e.g.   benchmarks/analysis_scaling.sh build/EdMedPhc_analysis protons 32
+#
+# Reads datasets/<particle>.root from the current directory. Run it once
+# beforehand so that the file is in the page cache for every point.
+
+ANALYSIS=$(realpath ${1:-./EdMedPhc_analysis})
+PARTICLE=${2:-protons}
+MAXTHREADS=${3:-$(nproc)}
+
+THREADS="1"
+N=2
+while [ $N -le $MAXTHREADS ]; do THREADS="$THREADS $N"; N=$((N*2)); done
+if [ $((N/2)) -ne $MAXTHREADS ] && [ $MAXTHREADS -gt 1 ]; then 
+    THREADS="$THREADS $MAXTHREADS"
+fi
+
+printf "%-8s %12s %10s %12s\n" threads time/s speedup efficiency
+for T in $THREADS; do
+    # " ----> particle: H deposits of E events analysed in T s with N threads"
+    TIME=$($ANALYSIS $PARTICLE -t $T -P 2>/dev/null \
+           | awk '/ ----> .*analysed/ { print $10 }')
+    if [ -z "$TIME" ]; then echo "analysis failed with $T threads"; exit 1; fi
+    if [ $T -eq 1 ]; then T1=$TIME; fi
+    awk -v t=$T -v time=$TIME -v t1=$T1 'BEGIN { 
+        printf "%-8d %12.3f %10.2f %11.0f%%\n", t, time, t1/time, 100*t1/(time*t) }'
+done
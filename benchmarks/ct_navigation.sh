@@ -0,0 +1,45 @@
+#!/bin/bash
+# Tracking rate in the CT phantom with and without the regular structure
+# navigation, on a 256^3 grid of 1 mm voxels from make_ct_phantom.
+#
+# Usage: benchmarks/ct_navigation.sh [build directory] [events] [threads]
+# e.g.   benchmarks/ct_navigation.sh build 2000 4
+
+BUILD=$(realpath ${1:-.})
+NEVENTS=${2:-2000}
+NTHREADS=${3:-1}
+
+WORKDIR=$(mktemp -d)
+trap 'rm -rf $WORKDIR' EXIT
+
+$BUILD/make_ct_phantom $WORKDIR/phantom.ct 256 1 || exit 1
+
+BEAMS="proton:200 gamma:10"
+
+printf "%-8s %-10s %12s %12s\n" particle navigation events/s steps/event
+for BEAM in $BEAMS; do
+    PARTICLE=${BEAM%%:*}
+    ENERGY=${BEAM##*:}
+    for REGULAR in true false; do
+        MACRO=$WORKDIR/${PARTICLE}_${REGULAR}.mac
+        cat > $MACRO <<EOM
+/EdMedPh/det/geometry ct
+/EdMedPh/det/ctFile $WORKDIR/phantom.ct
+/EdMedPh/det/regularNavigation $REGULAR
+/run/initialize
+/EdMedPh/dose/scoring false
+/gun/particle $PARTICLE
+/gun/energy $ENERGY MeV
+/run/printProgress 0
+/run/beamOn $NEVENTS
+EOM
+        LINE=$(cd $WORKDIR && $BUILD/EdMedPhc_executable -m $MACRO \
+                   -t $NTHREADS -o ${PARTICLE}_${REGULAR} 2>&1 \
+                   | grep "events/s")
+        # " ----> N events in T s : R events/s, S steps/event"
+        RATE=$(echo "$LINE" | awk '{print $8}')
+        STEPS=$(echo "$LINE" | awk '{print $10}')
+        [[ $REGULAR == true ]] && NAV=regular || NAV=generic
+        printf "%-8s %-10s %12s %12s\n" $PARTICLE $NAV $RATE $STEPS
+    done
+done
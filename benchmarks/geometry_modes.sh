@@ -0,0 +1,40 @@
+#!/bin/bash
+# Compare the layered and solid phantom geometries:
+# tracking rate (events/s) and steps/event for each beam particle.
+#
+# Usage: benchmarks/geometry_modes.sh [executable] [events] [threads]
+# e.g.   benchmarks/geometry_modes.sh build/EdMedPhc_executable 10000 4
+
+EXECUTABLE=$(realpath ${1:-./EdMedPhc_executable})
+NEVENTS=${2:-10000}
+NTHREADS=${3:-1}
+
+WORKDIR=$(mktemp -d)
+trap 'rm -rf $WORKDIR' EXIT
+
+# particle and energy of macros/<particle>s.mac
+BEAMS="proton:200 gamma:10 neutron:70"
+
+printf "%-8s %-8s %12s %12s\n" particle geometry events/s steps/event
+for BEAM in $BEAMS; do
+    PARTICLE=${BEAM%%:*}
+    ENERGY=${BEAM##*:}
+    for MODE in layered solid; do
+        MACRO=$WORKDIR/${PARTICLE}_${MODE}.mac
+        cat > $MACRO <<EOM
+/EdMedPh/det/geometry $MODE
+/run/initialize
+/EdMedPh/dose/scoring false
+/gun/particle $PARTICLE
+/gun/energy $ENERGY MeV
+/run/printProgress 0
+/run/beamOn $NEVENTS
+EOM
+        LINE=$(cd $WORKDIR && $EXECUTABLE -m $MACRO -t $NTHREADS \
+                   -o ${PARTICLE}_${MODE} 2>&1 | grep "events/s")
+        # " ----> N events in T s : R events/s, S steps/event"
+        RATE=$(echo "$LINE" | awk '{print $8}')
+        STEPS=$(echo "$LINE" | awk '{print $10}')
+        printf "%-8s %-8s %12s %12s\n" $PARTICLE $MODE $RATE $STEPS
+    done
+done
@@ -0,0 +1,128 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file make_ct_phantom.cc
+/// \brief Writes a synthetic thorax-like CT phantom for the ct geometry
+
+// Usage: make_ct_phantom file [n [voxelSize_mm]]
+//
+// n^3 voxels (default 256^3 of 1 mm): an elliptic water body in air with
+// two lungs and a bone spine, in the layout of EdMedPhCTFormat.hh.
+
+#include "EdMedPhCTFormat.hh"
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+namespace {
+  enum { kAir, kWater, kLung, kBone };
+
+  EdMedPhCTMaterial MakeMaterial(const char* name, double density)
+  {
+    EdMedPhCTMaterial material;
+    std::memset(material.name, 0, sizeof(material.name));
+    std::strncpy(material.name, name, sizeof(material.name) - 1);
+    material.density = density;
+    return material;
+  }
+
+  // inside the ellipse of centre (cx,cy) and half axes (ax,ay),
+  // in units of the phantom half width
+  bool Inside(double x, double y, double cx, double cy, double ax, double ay)
+  {
+    auto u = (x - cx)/ax;
+    auto v = (y - cy)/ay;
+    return u*u + v*v <= 1.;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+int main(int argc, char** argv)
+{
+  if ( argc < 2 ) {
+    std::cerr << "Usage: make_ct_phantom file [n [voxelSize_mm]]" << std::endl;
+    return 1;
+  }
+  int n = ( argc > 2 ) ? std::atoi(argv[2]) : 256;
+  double voxelSize = ( argc > 3 ) ? std::atof(argv[3]) : 1.;
+  if ( n <= 0 || voxelSize <= 0. ) {
+    std::cerr << "Invalid phantom size" << std::endl;
+    return 1;
+  }
+
+  EdMedPhCTHeader header;
+  std::memcpy(header.magic, "EDMPCT01", 8);
+  header.nx = header.ny = header.nz = n;
+  header.voxelSize[0] = header.voxelSize[1] = header.voxelSize[2] = voxelSize;
+
+  std::vector<EdMedPhCTMaterial> materials;
+  materials.push_back(MakeMaterial("G4_AIR", 0.00120479));
+  materials.push_back(MakeMaterial("G4_WATER", 1.0));
+  materials.push_back(MakeMaterial("G4_LUNG_ICRP", 0.30));
+  materials.push_back(MakeMaterial("G4_BONE_COMPACT_ICRU", 1.85));
+  header.nofMaterials = materials.size();
+
+  // the beam runs along z (depth), the body axis along y
+  std::vector<std::uint16_t> indices(std::size_t(n)*n*n);
+  std::size_t i = 0;
+  for ( int iz = 0; iz < n; ++iz ) {
+    auto z = 2.*(iz + 0.5)/n - 1.;
+    for ( int iy = 0; iy < n; ++iy ) {
+      for ( int ix = 0; ix < n; ++ix ) {
+        auto x = 2.*(ix + 0.5)/n - 1.;
+        std::uint16_t index = kAir;
+        if ( Inside(x, z, 0., 0., 0.95, 0.75) ) {
+          index = kWater;
+          if ( Inside(x, z, -0.45, -0.05, 0.3, 0.45) || 
+               Inside(x, z,  0.45, -0.05, 0.3, 0.45) ) index = kLung;
+          if ( Inside(x, z, 0., 0.55, 0.1, 0.1) ) index = kBone;
+        }
+        indices[i++] = index;
+      }
+    }
+  }
+
+  std::ofstream file(argv[1], std::ios::binary);
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  file.write(reinterpret_cast<const char*>(materials.data()), 
+             materials.size()*sizeof(EdMedPhCTMaterial));
+  file.write(reinterpret_cast<const char*>(indices.data()), 
+             indices.size()*sizeof(std::uint16_t));
+  if ( ! file ) {
+    std::cerr << "Cannot write " << argv[1] << std::endl;
+    return 1;
+  }
+
+  std::cout << argv[1] << " : " << n << "^3 voxels of " << voxelSize 
+            << " mm" << std::endl;
+  return 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
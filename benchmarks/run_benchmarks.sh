@@ -0,0 +1,71 @@
+#!/bin/bash
+# Fixed workloads of the simulation hot paths: the gammas, neutrons and
+# protons macros run headless (-v off) with their default per-event 
+# seeds on a fixed number of events, set by copying each macro with its
+# beamOn replaced by /EdMedPh/run/beamOn <events>. For each one, 
+# events/s, steps/s, ns per ProcessHits call, peak RSS and the bytes 
+# written are collected in a JSON file to compare builds.
+#
+# Usage: benchmarks/run_benchmarks.sh [build directory] [json file] [events] [threads]
+# e.g.   benchmarks/run_benchmarks.sh build build/benchmark.json 2000 4
+# (also run by the "benchmark" target of the build)
+
+SOURCE=$(realpath $(dirname $0)/..)
+BUILD=$(realpath ${1:-.})
+JSON=$(realpath ${2:-benchmark.json})
+NEVENTS=${3:-1000}
+NTHREADS=${4:-1}
+WORKLOADS="gammas neutrons protons"
+
+WORKDIR=$(mktemp -d)
+trap 'rm -rf $WORKDIR' EXIT
+
+COMMIT=$(git -C $SOURCE rev-parse --short HEAD 2> /dev/null)
+
+{
+    printf '{\n'
+    printf '  "commit": "%s",\n' "$COMMIT"
+    printf '  "date": "%s",\n' "$(date -u +%Y-%m-%dT%H:%M:%SZ)"
+    printf '  "host": "%s",\n' "$(hostname)"
+    printf '  "events": %d,\n' $NEVENTS
+    printf '  "threads": %d,\n' $NTHREADS
+    printf '  "workloads": ['
+} > $JSON
+
+SEPARATOR=""
+for WORKLOAD in $WORKLOADS; do
+    mkdir $WORKDIR/$WORKLOAD
+    LOG=$WORKDIR/$WORKLOAD.log
+    MACRO=$WORKDIR/$WORKLOAD.mac
+    sed -e "s|^/\(EdMedPh/\)\?run/beamOn .*|/EdMedPh/run/beamOn $NEVENTS|" \
+        $SOURCE/macros/$WORKLOAD.mac > $MACRO
+    ( cd $WORKDIR/$WORKLOAD && \
+          $BUILD/EdMedPhc_executable -m $MACRO \
+          -t $NTHREADS -v off -o $WORKLOAD > $LOG 2>&1 ) \
+        || { tail -20 $LOG; echo "$WORKLOAD failed"; exit 1; }
+
+    # " ----> N events in T s : R events/s, S steps/event, X steps/s"
+    # " ProcessHits : C calls/event, H ns/call"
+    # " peak RSS : M MB"
+    read EVENTS TIME RATE STEPS STEPRATE <<< $(awk \
+        '/ ----> .* events in / { print $2, $5, $8, $10, $12 }' $LOG)
+    read CALLS HITTIME <<< $(awk '/ ProcessHits : / { print $3, $5 }' $LOG)
+    RSS=$(awk '/ peak RSS : / { print $4 }' $LOG)
+    BYTES=$(find $WORKDIR/$WORKLOAD -type f -printf '%s\n' \
+                | awk '{ n += $1 } END { print n + 0 }')
+
+    printf '%s\n    { "name": "%s", "events": %s, "wall_s": %s,' \
+        "$SEPARATOR" $WORKLOAD $EVENTS $TIME >> $JSON
+    printf ' "events_per_s": %s, "steps_per_event": %s, "steps_per_s": %s,' \
+        $RATE $STEPS $STEPRATE >> $JSON
+    printf ' "process_hits_per_event": %s, "ns_per_process_hits": %s,' \
+        $CALLS $HITTIME >> $JSON
+    printf ' "peak_rss_mb": %s, "output_bytes": %s }' $RSS $BYTES >> $JSON
+    SEPARATOR=","
+
+    printf "%-10s %10s events/s %12s steps/s %8s ns/ProcessHits %8s MB %12s bytes\n" \
+        $WORKLOAD $RATE $STEPRATE $HITTIME $RSS $BYTES
+done
+
+printf '\n  ]\n}\n' >> $JSON
+echo "written to $JSON"
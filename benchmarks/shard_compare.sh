@@ -0,0 +1,55 @@
+#!/bin/bash
+# Run a job as one process and as several shard processes on this box,
+# merge the shards with EdMedPhc_merge and compare the merged dose map 
+# and region sums with the single process ones. With the per-event 
+# seeds they agree up to the rounding of the sums.
+#
+# Usage: benchmarks/shard_compare.sh [build directory] [events] [shards] [threads]
+# e.g.   benchmarks/shard_compare.sh build 2000 4 2
+
+BUILD=$(realpath ${1:-.})
+NEVENTS=${2:-2000}
+NSHARDS=${3:-4}
+NTHREADS=${4:-1}
+
+WORKDIR=$(mktemp -d)
+trap 'rm -rf $WORKDIR' EXIT
+
+MACRO=$WORKDIR/protons.mac
+cat > $MACRO <<EOM
+/run/initialize
+/gun/particle proton
+/gun/energy 200 MeV
+/EdMedPh/beam/energySpread 1 MeV
+/EdMedPh/beam/spotSize 3 mm
+/run/printProgress 0
+/EdMedPh/progress/interval 0
+/EdMedPh/run/beamOn $NEVENTS
+EOM
+
+cd $WORKDIR
+START=$(date +%s.%N)
+$BUILD/EdMedPhc_executable -m $MACRO -t $NTHREADS -o single \
+    > single.log 2>&1 || { cat single.log; exit 1; }
+SINGLE=$(awk -v s=$START -v e=$(date +%s.%N) 'BEGIN { print e - s }')
+
+START=$(date +%s.%N)
+SHARDS=""
+for (( i = 0; i < NSHARDS; i++ )); do
+    $BUILD/EdMedPhc_executable -m $MACRO -t $NTHREADS -o shard$i \
+        -s $i/$NSHARDS > shard$i.log 2>&1 &
+    pids[$i]=$!
+    SHARDS="$SHARDS shard$i"
+done
+for pid in ${pids[*]}; do
+    wait $pid || { cat shard*.log; exit 1; }
+done
+SPLIT=$(awk -v s=$START -v e=$(date +%s.%N) 'BEGIN { print e - s }')
+
+$BUILD/EdMedPhc_merge merged $SHARDS || exit 1
+if command -v hadd > /dev/null; then
+    hadd -f merged.root shard*.root > /dev/null
+fi
+
+echo "single process : $SINGLE s, $NSHARDS shards : $SPLIT s"
+$BUILD/EdMedPhc_merge -c single merged
@@ -0,0 +1,76 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhAliasTable.hh
+/// \brief Definition of the EdMedPhAliasTable class
+
+#ifndef EdMedPhAliasTable_h
+#define EdMedPhAliasTable_h 1
+
+#include "globals.hh"
+
+#include <vector>
+
+/// Walker alias table for sampling a discrete distribution in O(1)
+///
+/// Build() takes the (not necessarily normalised) weights of the n bins
+/// and prepares the probability and alias arrays (Vose's method).
+/// Sample() then needs a single uniform random number in [0,1) and one
+/// comparison, whatever the number of bins.
+
+class EdMedPhAliasTable
+{
+  public:
+    EdMedPhAliasTable();
+    ~EdMedPhAliasTable();
+
+    void Build(const std::vector<G4double>& weights);
+
+    inline G4int Sample(G4double u) const;
+
+    G4bool IsEmpty() const { return fProbability.empty(); }
+    G4int  GetNofBins() const { return fProbability.size(); }
+
+  private:
+    std::vector<G4double>  fProbability;
+    std::vector<G4int>     fAlias;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline G4int EdMedPhAliasTable::Sample(G4double u) const
+{
+  // the integer part picks the bin, the fractional part decides 
+  // between the bin and its alias
+  G4double x = u*fProbability.size();
+  auto i = static_cast<G4int>(x);
+  if ( i >= static_cast<G4int>(fProbability.size()) ) i--;
+  return ( x - i < fProbability[i] ) ? i : fAlias[i];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,99 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhBeamModel.hh
+/// \brief Definition of the EdMedPhBeamModel class
+
+#ifndef EdMedPhBeamModel_h
+#define EdMedPhBeamModel_h 1
+
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+
+#include "EdMedPhAliasTable.hh"
+
+#include <vector>
+
+namespace CLHEP { class HepRandomEngine; }
+
+/// Clinical beam model used by EdMedPhPrimaryGeneratorAction
+///
+/// The beam is described by:
+/// - a Gaussian energy spread (sigma) around the nominal energy,
+/// - a Gaussian spot (sigma, same in X and Y),
+/// - a Gaussian angular divergence (sigma, same in X and Y),
+/// - optionally, a list of weighted energy layers forming a spread-out 
+///   Bragg peak, which replace the nominal energy.
+///
+/// All the distributions are sampled from alias tables prepared once per
+/// run in BuildTables(): one for a standard normal distribution, 
+/// discretised over +-5 sigma, and one for the energy layers. Sampling a
+/// primary thus costs a fixed number of uniform random numbers; the only
+/// transcendental functions left are the two tangents of the divergence
+/// angles and the direction normalisation, when there is a divergence.
+/// With no spread, spot, divergence or layer the beam reduces to the 
+/// original mono-energetic pencil beam.
+
+class EdMedPhBeamModel
+{
+  public:
+    EdMedPhBeamModel();
+    ~EdMedPhBeamModel();
+
+    void BuildTables();
+
+    void Sample(CLHEP::HepRandomEngine* engine,
+                G4double nominalEnergy, const G4ThreeVector& axis,
+                G4ThreeVector& position, G4ThreeVector& direction, 
+                G4double& energy) const;
+
+    // set methods
+    void SetEnergySpread(G4double value) { fEnergySpread = value; }
+    void SetSpotSize(G4double value)     { fSpotSize = value; }
+    void SetDivergence(G4double value)   { fDivergence = value; }
+    void SetTableBins(G4int value)       { fTableBins = value; }
+    void AddLayer(G4double energy, G4double weight);
+    void ClearLayers();
+
+  private:
+    inline G4double SampleNormal(CLHEP::HepRandomEngine* engine) const;
+
+    G4double  fEnergySpread;  ///< energy sigma
+    G4double  fSpotSize;      ///< spot sigma in X and Y
+    G4double  fDivergence;    ///< angular sigma in X and Y
+    G4int     fTableBins;     ///< bins of the normal distribution table
+
+    std::vector<G4double>  fLayerEnergies;
+    std::vector<G4double>  fLayerWeights;
+
+    EdMedPhAliasTable  fNormalTable;
+    EdMedPhAliasTable  fLayerTable;
+    G4double  fNormalBinWidth;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
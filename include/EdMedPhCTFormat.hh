@@ -0,0 +1,63 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhCTFormat.hh
+/// \brief Definition of the CT phantom file layout
+
+#ifndef EdMedPhCTFormat_h
+#define EdMedPhCTFormat_h 1
+
+#include <cstdint>
+
+/// CT phantom file layout
+///
+/// A header (EdMedPhCTHeader), nofMaterials material entries 
+/// (EdMedPhCTMaterial) and nx*ny*nz uint16 material indices, x fastest
+/// then y then z as the copy numbers of G4PhantomParameterisation; little
+/// endian. The voxel sizes are in mm, the densities in g/cm3.
+/// This header has no Geant4 dependency so that phantom generators
+/// (benchmarks/make_ct_phantom.cc) can share it.
+
+struct EdMedPhCTHeader
+{
+  char          magic[8];   ///< "EDMPCT01"
+  std::int32_t  nx, ny, nz;
+  std::int32_t  nofMaterials;
+  double        voxelSize[3];
+};
+
+struct EdMedPhCTMaterial
+{
+  char    name[32];         ///< NIST base material, e.g. "G4_WATER"
+  double  density;          ///< density given to the base material
+};
+
+static_assert(sizeof(EdMedPhCTHeader) == 48, 
+              "unexpected CT header padding");
+static_assert(sizeof(EdMedPhCTMaterial) == 40, 
+              "unexpected CT material padding");
+
+#endif
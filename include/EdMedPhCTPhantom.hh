@@ -0,0 +1,79 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhCTPhantom.hh
+/// \brief Definition of the EdMedPhCTPhantom class
+
+#ifndef EdMedPhCTPhantom_h
+#define EdMedPhCTPhantom_h 1
+
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+
+#include <vector>
+
+class G4Material;
+
+/// Voxelised CT phantom read from a file in the EdMedPhCTFormat.hh layout
+///
+/// Each material entry becomes a NIST material built with the given 
+/// density; the material indices are kept in the form expected by 
+/// G4PhantomParameterisation::SetMaterialIndices().
+
+class EdMedPhCTPhantom
+{
+  public:
+    EdMedPhCTPhantom();
+    ~EdMedPhCTPhantom();
+
+    G4bool Read(const G4String& fileName);
+
+    G4int GetNx() const { return fNofVoxels[0]; }
+    G4int GetNy() const { return fNofVoxels[1]; }
+    G4int GetNz() const { return fNofVoxels[2]; }
+    const G4ThreeVector& GetVoxelSize() const { return fVoxelSize; }
+    G4ThreeVector GetSize() const;
+
+    std::vector<G4Material*>& GetMaterials() { return fMaterials; }
+    std::size_t* GetMaterialIndices() { return fMaterialIndices.data(); }
+
+  private:
+    G4int  fNofVoxels[3];
+    G4ThreeVector  fVoxelSize;
+    std::vector<G4Material*>  fMaterials;
+    std::vector<std::size_t>  fMaterialIndices;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline G4ThreeVector EdMedPhCTPhantom::GetSize() const
+{
+  return G4ThreeVector(fNofVoxels[0]*fVoxelSize.x(), 
+                       fNofVoxels[1]*fVoxelSize.y(), 
+                       fNofVoxels[2]*fVoxelSize.z());
+}
+
+#endif
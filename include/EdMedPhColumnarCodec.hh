@@ -0,0 +1,284 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhColumnarCodec.hh
+/// \brief Definition of the encodings of the columnar hit file chunks
+
+#ifndef EdMedPhColumnarCodec_h
+#define EdMedPhColumnarCodec_h 1
+
+#include "EdMedPhColumnarFormat.hh"
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#ifdef EDMEDPH_USE_ZLIB
+#include <zlib.h>
+#endif
+
+/// Chunk encodings of the columnar hit file
+///
+/// kPacked keeps Edep as float and quantizes X, Y and Z to multiples of
+/// the chunk quantum; the positions and the EventID are then stored as 
+/// the zigzag LEB128 varints of their differences to the previous row.
+/// Consecutive deposits are close along a track and the EventID of a
+/// thread only grows, so most rows take a few bytes instead of 20.
+/// kPackedZlib further deflates each packed column, prefixed with its 
+/// packed size (uint64), and is only available when built with zlib 
+/// (EDMEDPH_USE_ZLIB). A chunk with a position beyond the int32 range of
+/// the quantum cannot be packed: EncodeChunk() then fails.
+/// Header only and without Geant4 dependency: the simulation encodes 
+/// and the ROOT-free reader decodes with the same functions.
+
+namespace EdMedPhColumnar
+{
+  typedef std::vector<unsigned char> Bytes;
+
+  // the largest float below 2^31: quantized positions fit in an int32
+  constexpr float kMaxQuantumSteps = 2147483520.f;
+
+  inline bool HasZlib()
+  {
+#ifdef EDMEDPH_USE_ZLIB
+    return true;
+#else
+    return false;
+#endif
+  }
+
+  inline const char* GetCodecName(int codec)
+  {
+    switch ( codec ) {
+      case kRaw:        return "raw";
+      case kPacked:     return "packed";
+      case kPackedZlib: return "zlib";
+    }
+    return "unknown";
+  }
+
+  // variable length integers
+  //
+  inline void PutVarint(std::uint32_t value, Bytes& out)
+  {
+    while ( value >= 0x80 ) {
+      out.push_back(static_cast<unsigned char>(value | 0x80));
+      value >>= 7;
+    }
+    out.push_back(static_cast<unsigned char>(value));
+  }
+
+  inline bool GetVarint(const unsigned char*& in, const unsigned char* end,
+                        std::uint32_t& value)
+  {
+    value = 0;
+    for ( int shift = 0; shift < 35 && in < end; shift += 7 ) {
+      auto byte = *in++;
+      value |= std::uint32_t(byte & 0x7f) << shift;
+      if ( ! (byte & 0x80) ) return true;
+    }
+    return false;
+  }
+
+  // differences of consecutive values, wrapping around as uint32 and
+  // zigzag mapped so that small negative ones stay short
+  //
+  inline void PutDelta(std::int32_t value, std::int32_t& previous, 
+                       Bytes& out)
+  {
+    auto delta 
+      = std::int32_t(std::uint32_t(value) - std::uint32_t(previous));
+    PutVarint((std::uint32_t(delta) << 1) ^ std::uint32_t(delta >> 31), out);
+    previous = value;
+  }
+
+  inline bool GetDelta(const unsigned char*& in, const unsigned char* end,
+                       std::int32_t& previous)
+  {
+    std::uint32_t zigzag;
+    if ( ! GetVarint(in, end, zigzag) ) return false;
+    auto delta = (zigzag >> 1) ^ (0u - (zigzag & 1));
+    previous = std::int32_t(std::uint32_t(previous) + delta);
+    return true;
+  }
+
+  // columns
+  //
+  inline void PackFloats(const float* values, std::size_t n, Bytes& out)
+  {
+    auto data = reinterpret_cast<const unsigned char*>(values);
+    out.insert(out.end(), data, data + n*sizeof(float));
+  }
+
+  // false if a value, or NaN, is out of the int32 range once quantized
+  inline bool PackPositions(const float* values, std::size_t n, 
+                            float quantum, Bytes& out)
+  {
+    std::int32_t previous = 0;
+    for ( std::size_t i = 0; i < n; ++i ) {
+      auto steps = values[i]/quantum;
+      if ( ! ( std::fabs(steps) < kMaxQuantumSteps ) ) return false;
+      PutDelta(std::int32_t(std::lround(steps)), previous, out);
+    }
+    return true;
+  }
+
+  inline void PackIntegers(const std::int32_t* values, std::size_t n, 
+                           Bytes& out)
+  {
+    std::int32_t previous = 0;
+    for ( std::size_t i = 0; i < n; ++i ) PutDelta(values[i], previous, out);
+  }
+
+  inline bool UnpackFloats(const unsigned char* in, const unsigned char* end,
+                           std::size_t n, float* values)
+  {
+    if ( std::size_t(end - in) != n*sizeof(float) ) return false;
+    std::memcpy(values, in, n*sizeof(float));
+    return true;
+  }
+
+  inline bool UnpackPositions(const unsigned char* in, 
+                              const unsigned char* end,
+                              std::size_t n, float quantum, float* values)
+  {
+    std::int32_t previous = 0;
+    for ( std::size_t i = 0; i < n; ++i ) {
+      if ( ! GetDelta(in, end, previous) ) return false;
+      values[i] = previous*quantum;
+    }
+    return in == end;
+  }
+
+  inline bool UnpackIntegers(const unsigned char* in, 
+                             const unsigned char* end,
+                             std::size_t n, std::int32_t* values)
+  {
+    std::int32_t previous = 0;
+    for ( std::size_t i = 0; i < n; ++i ) {
+      if ( ! GetDelta(in, end, previous) ) return false;
+      values[i] = previous;
+    }
+    return in == end;
+  }
+
+  // deflate
+  //
+  inline bool Deflate(const Bytes& in, Bytes& out)
+  {
+#ifdef EDMEDPH_USE_ZLIB
+    std::uint64_t size = in.size();
+    auto bound = compressBound(uLong(in.size()));
+    out.resize(sizeof(size) + bound);
+    std::memcpy(out.data(), &size, sizeof(size));
+    if ( compress2(out.data() + sizeof(size), &bound, in.data(), 
+                   uLong(in.size()), Z_BEST_SPEED) != Z_OK ) return false;
+    out.resize(sizeof(size) + bound);
+    return true;
+#else
+    (void)in; (void)out;
+    return false;
+#endif
+  }
+
+  inline bool Inflate(const unsigned char* in, const unsigned char* end, 
+                      Bytes& out)
+  {
+#ifdef EDMEDPH_USE_ZLIB
+    std::uint64_t size;
+    if ( std::size_t(end - in) < sizeof(size) ) return false;
+    std::memcpy(&size, in, sizeof(size));
+    out.resize(size);
+    auto outSize = uLongf(size);
+    auto status = uncompress(out.data(), &outSize, in + sizeof(size), 
+                             uLong(end - in - sizeof(size)));
+    return status == Z_OK && outSize == size;
+#else
+    (void)in; (void)end; (void)out;
+    return false;
+#endif
+  }
+
+  // chunks
+  //
+  /// Encodes the columns of nofRows hits into columns[], in Column order
+  inline bool EncodeChunk(int codec, float quantum, std::size_t nofRows,
+                          const float* edep, const float* x, 
+                          const float* y, const float* z,
+                          const std::int32_t* eventID, Bytes columns[])
+  {
+    for ( int i = 0; i < kNofColumns; ++i ) columns[i].clear();
+    PackFloats(edep, nofRows, columns[kEdep]);
+    if ( ! PackPositions(x, nofRows, quantum, columns[kX])
+         || ! PackPositions(y, nofRows, quantum, columns[kY])
+         || ! PackPositions(z, nofRows, quantum, columns[kZ]) ) {
+      return false;
+    }
+    PackIntegers(eventID, nofRows, columns[kEventID]);
+
+    if ( codec == kPackedZlib ) {
+      Bytes deflated;
+      for ( int i = 0; i < kNofColumns; ++i ) {
+        if ( ! Deflate(columns[i], deflated) ) return false;
+        columns[i].swap(deflated);
+      }
+    }
+    return true;
+  }
+
+  /// Decodes the columns of an encoded chunk, given the start of each 
+  /// column in the file, into arrays of chunk.nofRows values
+  inline bool DecodeChunk(const EdMedPhColumnarChunk& chunk, 
+                          const unsigned char* const columns[],
+                          float* edep, float* x, float* y, float* z,
+                          std::int32_t* eventID)
+  {
+    const unsigned char* begin[kNofColumns];
+    const unsigned char* end[kNofColumns];
+    Bytes inflated[kNofColumns];
+    for ( int i = 0; i < kNofColumns; ++i ) {
+      begin[i] = columns[i];
+      end[i] = columns[i] + chunk.columnBytes[i];
+      if ( chunk.codec == kPackedZlib ) {
+        if ( ! Inflate(begin[i], end[i], inflated[i]) ) return false;
+        begin[i] = inflated[i].data();
+        end[i] = inflated[i].data() + inflated[i].size();
+      }
+      else if ( chunk.codec != kPacked ) {
+        return false;
+      }
+    }
+
+    std::size_t n = chunk.nofRows;
+    return UnpackFloats(begin[kEdep], end[kEdep], n, edep)
+        && UnpackPositions(begin[kX], end[kX], n, chunk.quantum, x)
+        && UnpackPositions(begin[kY], end[kY], n, chunk.quantum, y)
+        && UnpackPositions(begin[kZ], end[kZ], n, chunk.quantum, z)
+        && UnpackIntegers(begin[kEventID], end[kEventID], n, eventID);
+  }
+}
+
+#endif
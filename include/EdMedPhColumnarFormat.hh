@@ -0,0 +1,114 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhColumnarFormat.hh
+/// \brief Definition of the columnar hit file layout
+
+#ifndef EdMedPhColumnarFormat_h
+#define EdMedPhColumnarFormat_h 1
+
+#include <cstddef>
+#include <cstdint>
+
+/// Columnar hit file layout
+///
+/// A 64 byte header (EdMedPhColumnarHeader) followed by nofChunks chunks.
+/// Each chunk is a 64 byte chunk header (EdMedPhColumnarChunk) and then
+/// the kNofColumns columns of its nofRows hits, one after the other: 
+/// Edep [MeV], X, Y, Z [mm] as float and EventID as int32, each column 
+/// padded to 64 bytes so that every column starts cache line aligned in 
+/// a mapped file. Little endian.
+/// A chunk is one flush of the thread's EdMedPhHitBuffer, so the hits of
+/// one thread keep their event order within and across its chunks.
+///
+/// A chunk may instead be encoded (codec != kRaw, see 
+/// EdMedPhColumnarCodec.hh): its columns then take columnBytes[i] bytes,
+/// each still padded to 64, and must be decoded before use. The positions
+/// of encoded chunks are quantized to multiples of quantum [mm].
+/// This header has no Geant4 dependency so that the ROOT-free reader
+/// (analysis/include/EdMedPhColumnarReader.hh) can share it.
+
+struct EdMedPhColumnarHeader
+{
+  char           magic[8];      ///< "EDMPCOL1"
+  std::uint64_t  nofRows;
+  std::uint64_t  nofChunks;
+  std::uint32_t  nofColumns;    ///< kNofColumns
+  std::uint32_t  reserved[9];
+};
+
+struct EdMedPhColumnarChunk
+{
+  std::uint64_t  nofRows;
+  std::uint32_t  codec;           ///< EdMedPhColumnar::Codec
+  float          quantum;         ///< position step of encoded chunks
+  std::uint64_t  columnBytes[5];  ///< encoded column sizes, unpadded
+  std::uint64_t  reserved;
+};
+
+static_assert(sizeof(EdMedPhColumnarHeader) == 64, 
+              "unexpected columnar header padding");
+static_assert(sizeof(EdMedPhColumnarChunk) == 64, 
+              "unexpected columnar chunk padding");
+
+namespace EdMedPhColumnar
+{
+  enum Column { kEdep = 0, kX, kY, kZ, kEventID, kNofColumns };
+  enum Codec  { kRaw = 0, kPacked, kPackedZlib };
+
+  const std::size_t kAlignment = 64;
+  const std::size_t kBytesPerValue = 4;   ///< float or int32
+
+  /// Bytes taken by a column of size bytes, padding included
+  inline std::uint64_t PaddedSize(std::uint64_t size)
+  {
+    return (size + kAlignment - 1)/kAlignment*kAlignment;
+  }
+
+  /// Bytes taken by one raw column of a chunk of nofRows hits
+  inline std::uint64_t ColumnSize(std::uint64_t nofRows)
+  {
+    return PaddedSize(nofRows*kBytesPerValue);
+  }
+
+  /// Bytes taken by a column of the given chunk
+  inline std::uint64_t ColumnSize(const EdMedPhColumnarChunk& chunk, 
+                                  int column)
+  {
+    return chunk.codec == kRaw 
+      ? ColumnSize(chunk.nofRows) : PaddedSize(chunk.columnBytes[column]);
+  }
+
+  /// Bytes taken by the given chunk, chunk header included
+  inline std::uint64_t ChunkSize(const EdMedPhColumnarChunk& chunk)
+  {
+    auto size = std::uint64_t(sizeof(EdMedPhColumnarChunk));
+    for ( int i = 0; i < kNofColumns; ++i ) size += ColumnSize(chunk, i);
+    return size;
+  }
+}
+
+#endif
@@ -0,0 +1,92 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhColumnarWriter.hh
+/// \brief Definition of the EdMedPhColumnarWriter class
+
+#ifndef EdMedPhColumnarWriter_h
+#define EdMedPhColumnarWriter_h 1
+
+#include "globals.hh"
+
+#include "EdMedPhColumnarCodec.hh"
+
+#include <fstream>
+#include <vector>
+
+/// Thread-local columnar hit file writer
+///
+/// Each WriteChunk() call writes the columns of one EdMedPhHitBuffer 
+/// flush as they are, without a per row copy; the header counts are 
+/// patched in Close(). In MT mode each worker writes its own part file 
+/// and the master concatenates the chunks with MergeFiles() at the end of
+/// the run. See EdMedPhColumnarFormat.hh for the layout.
+///
+/// With SetCodec() the chunks are encoded instead (EdMedPhColumnarCodec.hh)
+/// and the raw and written byte counts give the compression ratio.
+
+class EdMedPhColumnarWriter
+{
+  public:
+    EdMedPhColumnarWriter();
+    ~EdMedPhColumnarWriter();
+
+    // the quantum is raised if needed so that positions up to
+    // maxPosition, in absolute value, can be packed
+    void SetCodec(G4int codec, G4double quantum, G4double maxPosition);
+
+    G4bool Open(const G4String& fileName);
+    void   Close();
+
+    void WriteChunk(std::size_t nofRows, 
+                    const float* edep, const float* x, const float* y,
+                    const float* z, const std::int32_t* eventID);
+
+    G4bool IsOpen() const { return fFile.is_open(); }
+    G4int  GetCodec() const { return fCodec; }
+    // bytes of the chunks as raw columns and as written, since Open()
+    G4double GetRawBytes() const     { return fRawBytes; }
+    G4double GetWrittenBytes() const { return fWrittenBytes; }
+
+    static G4bool MergeFiles(const G4String& fileName, 
+                             const std::vector<G4String>& partFileNames);
+
+  private:
+    void WriteColumn(const void* data, std::size_t size);
+
+    std::ofstream  fFile;
+    std::uint64_t  fNofRows;
+    std::uint64_t  fNofChunks;
+    G4int          fCodec;
+    float          fQuantum;    ///< [mm]
+    EdMedPhColumnar::Bytes  fColumns[EdMedPhColumnar::kNofColumns];
+    G4double       fRawBytes;
+    G4double       fWrittenBytes;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
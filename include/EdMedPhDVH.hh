@@ -0,0 +1,70 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhDVH.hh
+/// \brief Definition of the EdMedPhDVH class
+
+#ifndef EdMedPhDVH_h
+#define EdMedPhDVH_h 1
+
+#include "globals.hh"
+
+#include <vector>
+
+/// Cumulative dose-volume histogram of a region
+///
+/// It collects the doses of the equal-volume voxels of the region with 
+/// AddVoxel() and sorts them in Finish(); then GetVolumeFraction(D) is
+/// the fraction of the region receiving at least D and GetDose(v) is 
+/// D_v, the minimum dose of the hottest fraction v of the region (e.g.
+/// D95 = GetDose(0.95)). EdMedPhRunAction fills one per region of 
+/// interest, and one for the voxels outside all of them, from the dose
+/// grid merged at the end of the run.
+
+class EdMedPhDVH
+{
+  public:
+    EdMedPhDVH(const G4String& name);
+    ~EdMedPhDVH();
+
+    void AddVoxel(G4double dose) { fDoses.push_back(dose); }
+    void Finish();
+
+    const G4String& GetName() const { return fName; }
+    G4int    GetNofVoxels() const { return fDoses.size(); }
+    G4double GetVolumeFraction(G4double dose) const;
+    G4double GetDose(G4double volumeFraction) const;
+    G4double GetMeanDose() const;
+    G4double GetMaxDose() const { return fDoses.empty() ? 0. : fDoses.front(); }
+
+  private:
+    G4String fName;
+    std::vector<G4double> fDoses;  // sorted in decreasing order by Finish()
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
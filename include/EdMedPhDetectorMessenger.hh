@@ -0,0 +1,88 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhDetectorMessenger.hh
+/// \brief Definition of the EdMedPhDetectorMessenger class
+
+#ifndef EdMedPhDetectorMessenger_h
+#define EdMedPhDetectorMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class EdMedPhcDetectorConstruction;
+class G4UIdirectory;
+class G4UIcmdWithAString;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWithABool;
+
+/// Messenger class for the geometry options of EdMedPhcDetectorConstruction
+///
+/// It defines the following commands:
+/// - /EdMedPh/det/geometry       layered|solid|ct
+/// - /EdMedPh/det/nofLayers      n
+/// - /EdMedPh/det/absoThickness  value unit
+/// - /EdMedPh/det/gapThickness   value unit
+/// - /EdMedPh/det/sizeXY         value unit
+/// - /EdMedPh/det/absoMaterial   name
+/// - /EdMedPh/det/gapMaterial    name
+/// - /EdMedPh/det/ctFile         fileName
+/// - /EdMedPh/det/regularNavigation  true|false
+/// - /EdMedPh/det/gapSD          true|false
+/// - /EdMedPh/det/exportHits     true|false
+///
+/// The commands are executed by the master only, which rebuilds the
+/// geometry shared by the workers.
+
+class EdMedPhDetectorMessenger: public G4UImessenger
+{
+  public:
+    EdMedPhDetectorMessenger(EdMedPhcDetectorConstruction* detector);
+    virtual ~EdMedPhDetectorMessenger();
+
+    virtual void SetNewValue(G4UIcommand* command, G4String newValue);
+
+  private:
+    EdMedPhcDetectorConstruction*  fDetector;
+
+    G4UIdirectory*       fDetDirectory;
+    G4UIcmdWithAString*  fGeometryCmd;
+    G4UIcmdWithAnInteger*  fNofLayersCmd;
+    G4UIcmdWithADoubleAndUnit*  fAbsoThicknessCmd;
+    G4UIcmdWithADoubleAndUnit*  fGapThicknessCmd;
+    G4UIcmdWithADoubleAndUnit*  fSizeXYCmd;
+    G4UIcmdWithAString*  fAbsoMaterialCmd;
+    G4UIcmdWithAString*  fGapMaterialCmd;
+    G4UIcmdWithAString*  fCTFileCmd;
+    G4UIcmdWithABool*    fRegularNavigationCmd;
+    G4UIcmdWithABool*    fGapSDCmd;
+    G4UIcmdWithABool*    fExportHitsCmd;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,103 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhDoseGrid.hh
+/// \brief Definition of the EdMedPhDoseGrid class
+
+#ifndef EdMedPhDoseGrid_h
+#define EdMedPhDoseGrid_h 1
+
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+
+#include <vector>
+
+/// Voxelised energy deposit accumulator
+///
+/// A regular nx x ny x nz grid over the phantom, in the same frame as the
+/// ntuple positions: X and Y centred on the beam axis, Z measured from the
+/// phantom entrance face. Each worker thread owns one grid (via EdMedPhRun);
+/// the grids are summed into the master one in EdMedPhRun::Merge() and
+/// written once at the end of the run.
+///
+/// The energy deposit is stored in MeV, so that grids from different
+/// threads or jobs can simply be added; the dose is obtained by dividing
+/// by the voxel mass.
+
+class EdMedPhDoseGrid
+{
+  public:
+    EdMedPhDoseGrid();
+    ~EdMedPhDoseGrid();
+
+    void SetBinning(G4int nx, G4int ny, G4int nz, 
+                    const G4ThreeVector& lower, const G4ThreeVector& upper);
+    void Reset();
+    void Merge(const EdMedPhDoseGrid& other);
+
+    inline void Fill(G4double x, G4double y, G4double z, G4double edep);
+
+    void Write(const G4String& fileName) const;
+
+    // get methods
+    G4bool   IsEnabled() const   { return ! fEdep.empty(); }
+    G4int    GetNx() const       { return fNx; }
+    G4int    GetNy() const       { return fNy; }
+    G4int    GetNz() const       { return fNz; }
+    G4int    GetNofVoxels() const { return fNx*fNy*fNz; }
+    G4double GetVoxelVolume() const;
+    G4double GetEdep(G4int i) const { return fEdep[i]; }
+    G4double GetTotalEdep() const;
+    G4ThreeVector GetVoxelCentre(G4int i) const;
+
+  private:
+    G4int    fNx, fNy, fNz;
+    G4ThreeVector fLower;
+    G4ThreeVector fUpper;
+    G4double fInvDx, fInvDy, fInvDz; ///< inverse voxel sizes
+    std::vector<G4double> fEdep;     ///< x index runs fastest
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline void EdMedPhDoseGrid::Fill(G4double x, G4double y, G4double z, 
+                                  G4double edep)
+{
+  G4double u = (x - fLower.x())*fInvDx;
+  G4double v = (y - fLower.y())*fInvDy;
+  G4double w = (z - fLower.z())*fInvDz;
+  if ( u < 0. || v < 0. || w < 0. || u >= fNx || v >= fNy || w >= fNz ) {
+    return;
+  }
+
+  auto i = (static_cast<G4int>(w)*fNy + static_cast<G4int>(v))*fNx 
+         + static_cast<G4int>(u);
+  fEdep[i] += edep;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
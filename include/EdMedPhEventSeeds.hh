@@ -0,0 +1,90 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhEventSeeds.hh
+/// \brief Definition of the per-event seeds of the random engine
+
+#ifndef EdMedPhEventSeeds_h
+#define EdMedPhEventSeeds_h 1
+
+#include "globals.hh"
+
+#include <cstdint>
+
+/// Seeds of the random engine derived from (run seed, run ID, event ID)
+///
+/// The key is hashed with the SplitMix64 finalizer, so that neighbouring
+/// events get uncorrelated seeds. The two seeds are kept within the 
+/// moduli of RanecuEngine, which MixMaxRng accepts as well.
+/// An event then depends only on its own key: neither on the number of
+/// threads, nor on the events simulated before it by the same thread.
+
+namespace EdMedPhRandom
+{
+  inline std::uint64_t SplitMix64(std::uint64_t& state)
+  {
+    std::uint64_t z = ( state += 0x9e3779b97f4a7c15ULL );
+    z = ( z ^ ( z >> 30 ) ) * 0xbf58476d1ce4e5b9ULL;
+    z = ( z ^ ( z >> 27 ) ) * 0x94d049bb133111ebULL;
+    return z ^ ( z >> 31 );
+  }
+
+  // seeds[0..1] are set from 64 random bits, seeds[2] terminates the list
+  inline void SetSeeds(std::uint64_t bits, long seeds[3])
+  {
+    seeds[0] = 1 + long(( bits & 0xffffffffULL ) % 2147483562ULL);
+    seeds[1] = 1 + long(( bits >> 32 ) % 2147483398ULL);
+    seeds[2] = 0;
+  }
+
+  inline void GetEventSeeds(std::uint64_t runSeed, G4int runID, G4int eventID,
+                            long seeds[3])
+  {
+    std::uint64_t state = runSeed;
+    state = SplitMix64(state) 
+          ^ ( std::uint64_t(std::uint32_t(runID)) << 32 ) 
+          ^ std::uint64_t(std::uint32_t(eventID));
+    SetSeeds(SplitMix64(state), seeds);
+  }
+
+  // Seeds of the master stream of a shard of a split job, keyed by
+  // (job seed, shard index, number of shards). The key is offset by a 
+  // constant of its own, so that no shard stream repeats the stream of
+  // an event whose run seed is the job seed.
+  inline void GetShardSeeds(std::uint64_t jobSeed, G4int shardIndex,
+                            G4int nofShards, long seeds[3])
+  {
+    std::uint64_t state = jobSeed ^ 0x5368617264536565ULL;
+    state = SplitMix64(state) 
+          ^ ( std::uint64_t(std::uint32_t(nofShards)) << 32 ) 
+          ^ std::uint64_t(std::uint32_t(shardIndex));
+    SetSeeds(SplitMix64(state), seeds);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,108 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhHitBuffer.hh
+/// \brief Definition of the EdMedPhHitBuffer class
+
+#ifndef EdMedPhHitBuffer_h
+#define EdMedPhHitBuffer_h 1
+
+#include "globals.hh"
+
+#include <cstdint>
+#include <vector>
+
+class EdMedPhColumnarWriter;
+
+/// Thread-local buffer of step level energy deposits
+///
+/// EdMedPhcCalorimeterSD::ProcessHits() appends the deposit to the 
+/// structure-of-arrays buffer below, which is flushed when full, from
+/// Append() during tracking, or at the end of the run. To the ntuple,
+/// whose columns are float (Edep, X, Y, Z) and int (EventID), a flush 
+/// still fills the columns and adds the rows one by one, as 
+/// G4AnalysisManager has no block fill. Only with a columnar writer set
+/// are the rows written in batches, each flush being one chunk of the 
+/// columnar hit file (/EdMedPh/output/stepFormat columnar).
+///
+/// The time spent in Flush() and the number of rows written are kept so
+/// that the run action can report the measured cost per row of either 
+/// sink.
+
+class EdMedPhHitBuffer
+{
+  public:
+    EdMedPhHitBuffer();
+    ~EdMedPhHitBuffer();
+
+    void SetCapacity(G4int capacity);
+    void SetNtupleId(G4int id) { fNtupleId = id; }
+    void SetColumnarWriter(EdMedPhColumnarWriter* writer) 
+           { fColumnarWriter = writer; }
+
+    inline void Append(G4double edep, G4double x, G4double y, G4double z,
+                       G4int eventID);
+    void Flush();
+    void ResetStatistics();
+
+    // get methods
+    G4bool   IsEnabled() const    { return fCapacity > 0; }
+    G4int    GetCapacity() const  { return fCapacity; }
+    G4double GetNofRows() const   { return fNofRows; }
+    G4double GetFlushTime() const { return fFlushTime; }
+
+  private:
+    G4int  fNtupleId;
+    EdMedPhColumnarWriter*  fColumnarWriter;
+    G4int  fCapacity;
+    G4int  fSize;
+    std::vector<float>  fEdep;
+    std::vector<float>  fX;
+    std::vector<float>  fY;
+    std::vector<float>  fZ;
+    std::vector<std::int32_t>  fEventID;
+
+    G4double  fNofRows;    ///< rows flushed since ResetStatistics()
+    G4double  fFlushTime;  ///< real time spent in Flush() [s]
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline void EdMedPhHitBuffer::Append(G4double edep, 
+                                     G4double x, G4double y, G4double z,
+                                     G4int eventID)
+{
+  fEdep[fSize] = edep;
+  fX[fSize] = x;
+  fY[fSize] = y;
+  fZ[fSize] = z;
+  fEventID[fSize] = eventID;
+  if ( ++fSize == fCapacity ) Flush();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
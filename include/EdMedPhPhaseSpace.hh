@@ -0,0 +1,74 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhPhaseSpace.hh
+/// \brief Definition of the phase-space file layout
+
+#ifndef EdMedPhPhaseSpace_h
+#define EdMedPhPhaseSpace_h 1
+
+#include <cstdint>
+
+/// Phase-space file layout
+///
+/// A 16 byte header (EdMedPhPhaseSpaceHeader) followed by fixed size
+/// records (EdMedPhPhaseSpaceRecord, 36 bytes) and by the event index
+/// (EdMedPhPhaseSpaceGroup, 16 bytes per event), little endian.
+/// The records of one event are contiguous; the index, written by 
+/// EdMedPhPhaseSpaceWriter in event ID order, gives their position so 
+/// that readers need not scan the records.
+/// Positions are in mm, energies in MeV.
+
+struct EdMedPhPhaseSpaceHeader
+{
+  char          magic[8];   ///< "EDMPPHSP"
+  std::uint64_t nofRecords;
+};
+
+struct EdMedPhPhaseSpaceRecord
+{
+  std::int32_t  eventID;
+  std::int32_t  pdgCode;
+  float  energy;
+  float  x, y, z;
+  float  dx, dy, dz;
+};
+
+struct EdMedPhPhaseSpaceGroup
+{
+  std::int32_t  eventID;
+  std::uint32_t nofRecords;
+  std::uint64_t firstRecord;
+};
+
+static_assert(sizeof(EdMedPhPhaseSpaceHeader) == 16, 
+              "unexpected phase-space header padding");
+static_assert(sizeof(EdMedPhPhaseSpaceRecord) == 36, 
+              "unexpected phase-space record padding");
+static_assert(sizeof(EdMedPhPhaseSpaceGroup) == 16, 
+              "unexpected phase-space group padding");
+
+#endif
@@ -0,0 +1,92 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhPhaseSpaceReader.hh
+/// \brief Definition of the EdMedPhPhaseSpaceReader class
+
+#ifndef EdMedPhPhaseSpaceReader_h
+#define EdMedPhPhaseSpaceReader_h 1
+
+#include "globals.hh"
+
+#include "EdMedPhPhaseSpace.hh"
+
+/// Memory-mapped phase-space file reader
+///
+/// Open() maps the file read-only and takes the event index from the end
+/// of the file, so opening costs no read of the records. Each thread owns
+/// its reader; the mapped pages are shared through the page cache. 
+/// Event i of a run replays the i-th recorded event in event ID order,
+/// modulo GetNofEvents(), so threads, which process disjoint event IDs,
+/// read disjoint parts of the file. A file without index is rejected.
+
+class EdMedPhPhaseSpaceReader
+{
+  public:
+    EdMedPhPhaseSpaceReader();
+    ~EdMedPhPhaseSpaceReader();
+
+    G4bool Open(const G4String& fileName);
+    void   Close();
+
+    G4bool IsOpen() const { return fRecords != nullptr; }
+    const G4String& GetFileName() const { return fFileName; }
+    std::size_t GetNofEvents() const;
+
+    // records of the event group replayed for the given event ID
+    const EdMedPhPhaseSpaceRecord* Begin(G4int eventID) const;
+    const EdMedPhPhaseSpaceRecord* End(G4int eventID) const;
+
+  private:
+    G4String     fFileName;
+    void*        fMapping;
+    std::size_t  fMappingSize;
+    const EdMedPhPhaseSpaceRecord*  fRecords;
+    const EdMedPhPhaseSpaceGroup*   fGroups;
+    std::size_t  fNofGroups;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline std::size_t EdMedPhPhaseSpaceReader::GetNofEvents() const
+{
+  return fNofGroups;
+}
+
+inline const EdMedPhPhaseSpaceRecord* 
+EdMedPhPhaseSpaceReader::Begin(G4int eventID) const
+{
+  return fRecords + fGroups[eventID % fNofGroups].firstRecord;
+}
+
+inline const EdMedPhPhaseSpaceRecord* 
+EdMedPhPhaseSpaceReader::End(G4int eventID) const
+{
+  const auto& group = fGroups[eventID % fNofGroups];
+  return fRecords + group.firstRecord + group.nofRecords;
+}
+
+#endif
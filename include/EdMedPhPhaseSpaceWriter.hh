@@ -0,0 +1,76 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhPhaseSpaceWriter.hh
+/// \brief Definition of the EdMedPhPhaseSpaceWriter class
+
+#ifndef EdMedPhPhaseSpaceWriter_h
+#define EdMedPhPhaseSpaceWriter_h 1
+
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+
+#include "EdMedPhPhaseSpace.hh"
+
+#include <fstream>
+#include <vector>
+
+/// Thread-local phase-space file writer
+///
+/// Records are buffered and written in blocks; Close() appends the event
+/// index, sorted by event ID, and patches the header record count. In MT
+/// mode each worker writes its own part file and the master concatenates
+/// them with MergeFiles() at the end of the run, merging their indexes.
+
+class EdMedPhPhaseSpaceWriter
+{
+  public:
+    EdMedPhPhaseSpaceWriter();
+    ~EdMedPhPhaseSpaceWriter();
+
+    G4bool Open(const G4String& fileName);
+    void   Close();
+
+    void Record(G4int eventID, G4int pdgCode, G4double energy,
+                const G4ThreeVector& position, const G4ThreeVector& direction);
+
+    G4bool IsOpen() const { return fFile.is_open(); }
+
+    static G4bool MergeFiles(const G4String& fileName, 
+                             const std::vector<G4String>& partFileNames);
+
+  private:
+    void Flush();
+
+    std::ofstream  fFile;
+    std::vector<EdMedPhPhaseSpaceRecord>  fBuffer;
+    std::uint64_t  fNofRecords;
+    std::vector<EdMedPhPhaseSpaceGroup>  fGroups;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -32,10 +32,19 @@
 #define EdMedPhPrimaryGeneratorAction_h 1
 
 #include "G4VUserPrimaryGeneratorAction.hh"
+#include "G4ThreeVector.hh"
 #include "globals.hh"
 
+#include "EdMedPhBeamModel.hh"
+#include "EdMedPhPhaseSpaceReader.hh"
+
+#include <vector>
+
 class G4ParticleGun;
 class G4Event;
+class G4ParticleDefinition;
+class EdMedPhPrimaryGeneratorMessenger;
+class EdMedPhPhaseSpaceWriter;
 
 /// The primary generator action class with particle gum.
 ///
@@ -43,6 +52,29 @@ class G4Event;
 /// perpendicular to the input face. The type of the particle
 /// can be changed via the G4 build-in commands of G4ParticleGun class 
 /// (see the macros provided with this example).
+///
+/// The gun geometry (world Z half-length) is resolved once per run in
+/// BeginOfRun(), called by EdMedPhRunAction, which also prepares the
+/// sampling tables of the beam model (EdMedPhBeamModel: energy spread, 
+/// spot size, divergence, SOBP layers, set via /EdMedPh/beam/). The 
+/// primary kinematics are then sampled in batches of 
+/// /EdMedPh/beam/batchSize primaries, and GeneratePrimaries() only builds 
+/// the vertex of the next one.
+///
+/// With /EdMedPh/beam/phaseSpace the primaries are instead replayed from
+/// a phase-space file (see EdMedPhPhaseSpace.hh), memory-mapped by
+/// EdMedPhPhaseSpaceReader. When EdMedPhRunAction passes a phase-space 
+/// writer, the generated primaries are recorded to it.
+///
+/// With /EdMedPh/random/eventSeeds (on by default) the random engine is
+/// reseeded at each event from (/EdMedPh/random/runSeed, run ID, event ID),
+/// see EdMedPhEventSeeds.hh, and the primary is sampled after the reseeding
+/// instead of being taken from a batch. The results then do not depend on
+/// the number of threads and /EdMedPh/random/replayEvent can re-simulate
+/// any event alone: the events of the next runs are renumbered from the
+/// replayed one and get its seeds. /EdMedPh/random/firstEvent only 
+/// renumbers the events, so that the shard of a split job 
+/// (see EdMedPhRunAction::BeamOn()) simulates its events as in the whole job.
 
 class EdMedPhPrimaryGeneratorAction : public G4VUserPrimaryGeneratorAction
 {
@@ -51,12 +83,52 @@ public:
   virtual ~EdMedPhPrimaryGeneratorAction();
 
   virtual void GeneratePrimaries(G4Event* event);
+
+  void BeginOfRun();
   
   // set methods
   void SetRandomFlag(G4bool value);
+  void SetBatchSize(G4int value);
+  void SetPhaseSpaceFile(const G4String& fileName);
+  void SetPhaseSpaceWriter(EdMedPhPhaseSpaceWriter* writer);
+  void SetEventSeeds(G4bool value);
+  void SetRunSeed(G4long value);
+  void SetReplayEvent(G4int eventID, G4int runID = 0);
+  void SetFirstEvent(G4int eventID);
+
+  // get methods
+  EdMedPhBeamModel& GetBeamModel() { return fBeamModel; }
 
 private:
+  struct Primary {
+    G4ThreeVector  position;
+    G4ThreeVector  direction;
+    G4double  energy;
+  };
+
+  void FillBatch();
+  void SamplePrimary(CLHEP::HepRandomEngine* engine, Primary& primary) const;
+  void SeedEvent(G4Event* event);
+  void ReplayPhaseSpace(G4Event* event);
+  G4ParticleDefinition* FindParticle(G4int pdgCode) const;
+
   G4ParticleGun*  fParticleGun; // G4 particle gun
+  EdMedPhPrimaryGeneratorMessenger*  fMessenger;
+  EdMedPhBeamModel  fBeamModel;
+
+  G4double  fWorldZHalfLength;  // resolved in BeginOfRun()
+  std::vector<Primary>  fBatch;
+  std::size_t  fNext;           // next primary to use in fBatch
+  G4bool  fBatchSizeSet;        // set by /EdMedPh/beam/batchSize
+
+  G4String  fPhaseSpaceFileName;
+  EdMedPhPhaseSpaceReader  fPhaseSpace;
+  EdMedPhPhaseSpaceWriter*  fPhaseSpaceWriter;
+
+  G4bool  fEventSeeds;
+  G4long  fRunSeed;
+  G4int   fFirstEvent;          // ID of the first event of the next runs
+  G4int   fSeedRunID;           // replayed run, -1 if none
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
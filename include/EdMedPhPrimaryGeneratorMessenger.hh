@@ -0,0 +1,95 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhPrimaryGeneratorMessenger.hh
+/// \brief Definition of the EdMedPhPrimaryGeneratorMessenger class
+
+#ifndef EdMedPhPrimaryGeneratorMessenger_h
+#define EdMedPhPrimaryGeneratorMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class EdMedPhPrimaryGeneratorAction;
+class G4UIdirectory;
+class G4UIcommand;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWithoutParameter;
+class G4UIcmdWithAString;
+class G4UIcmdWithABool;
+
+/// Messenger class for the beam options of EdMedPhPrimaryGeneratorAction
+///
+/// It defines the following commands:
+/// - /EdMedPh/beam/batchSize     n
+/// - /EdMedPh/beam/energySpread  sigma unit
+/// - /EdMedPh/beam/spotSize      sigma unit
+/// - /EdMedPh/beam/divergence    sigma unit
+/// - /EdMedPh/beam/tableBins     n
+/// - /EdMedPh/beam/sobp/addLayer energy unit weight
+/// - /EdMedPh/beam/sobp/clear
+/// - /EdMedPh/beam/phaseSpace    fileName|none
+/// - /EdMedPh/random/eventSeeds  true|false
+/// - /EdMedPh/random/runSeed     seed
+/// - /EdMedPh/random/replayEvent eventID [runID]
+/// - /EdMedPh/random/firstEvent  eventID
+///
+/// The particle type and nominal energy are still set with the /gun/
+/// commands of G4ParticleGun.
+
+class EdMedPhPrimaryGeneratorMessenger: public G4UImessenger
+{
+  public:
+    EdMedPhPrimaryGeneratorMessenger(EdMedPhPrimaryGeneratorAction* action);
+    virtual ~EdMedPhPrimaryGeneratorMessenger();
+
+    virtual void SetNewValue(G4UIcommand* command, G4String newValue);
+
+  private:
+    EdMedPhPrimaryGeneratorAction*  fAction;
+
+    G4UIdirectory*         fBeamDirectory;
+    G4UIdirectory*         fSobpDirectory;
+    G4UIcmdWithAnInteger*  fBatchSizeCmd;
+    G4UIcmdWithADoubleAndUnit*  fEnergySpreadCmd;
+    G4UIcmdWithADoubleAndUnit*  fSpotSizeCmd;
+    G4UIcmdWithADoubleAndUnit*  fDivergenceCmd;
+    G4UIcmdWithAnInteger*  fTableBinsCmd;
+    G4UIcommand*           fAddLayerCmd;
+    G4UIcmdWithoutParameter*  fClearLayersCmd;
+    G4UIcmdWithAString*    fPhaseSpaceCmd;
+
+    G4UIdirectory*         fRandomDirectory;
+    G4UIcmdWithABool*      fEventSeedsCmd;
+    G4UIcmdWithAnInteger*  fRunSeedCmd;
+    G4UIcommand*           fReplayEventCmd;
+    G4UIcmdWithAnInteger*  fFirstEventCmd;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
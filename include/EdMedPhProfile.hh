@@ -0,0 +1,119 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhProfile.hh
+/// \brief Definition of the EdMedPhProfile class
+
+#ifndef EdMedPhProfile_h
+#define EdMedPhProfile_h 1
+
+#include "globals.hh"
+
+#include <chrono>
+#include <map>
+#include <tuple>
+
+class G4Step;
+class G4Track;
+class G4ParticleDefinition;
+class G4VProcess;
+class G4LogicalVolume;
+
+/// Time profile of the steps of a run
+///
+/// EdMedPhTrackingAction starts the clock of each track with StartTrack()
+/// and EdMedPhSteppingAction stops it at each step with EndStep(). The 
+/// time since the previous step (or the start of the track) is added 
+/// with the step count to the (particle, process that limited the step,
+/// pre-step logical volume) of the step. The time then covers the 
+/// transport and physics of the step and the scoring of its sensitive 
+/// detector, but not the stacking of the secondaries nor the work done
+/// at the ends of the events.
+///
+/// The thread-local profile of a worker run is keyed by pointers, so a 
+/// step costs a clock reading and a small map update; Merge() adds it to
+/// the master profile by names. Print() reports the time and steps per
+/// particle, per process, per volume and per (particle, process).
+
+class EdMedPhProfile
+{
+  public:
+    EdMedPhProfile();
+    ~EdMedPhProfile();
+
+    inline void StartTrack(const G4Track* track);
+    inline void EndStep(const G4Step* step);
+    void Merge(const EdMedPhProfile& other);
+
+    G4double GetTime() const;
+    // the time shares are relative to eventTime, the wall time in events
+    void Print(G4double eventTime) const;
+
+  private:
+    struct Entry
+    {
+      G4double  nofSteps = 0.;
+      G4double  time = 0.;      // [s]
+    };
+    typedef std::chrono::steady_clock Clock;
+    typedef std::tuple<const G4ParticleDefinition*, const G4VProcess*, 
+                       const G4LogicalVolume*> Key;
+    typedef std::tuple<G4String, G4String, G4String> Names;
+
+    void AddStep(const G4Step* step, G4double time);
+    void AddTrack(const G4Track* track);
+    std::map<Names, Entry> GetNamedEntries() const;
+    std::map<G4String, G4double> GetNamedTracks() const;
+
+    Clock::time_point  fLastTime;
+    std::map<Key, Entry>  fEntries;
+    std::map<const G4ParticleDefinition*, G4double>  fTracks;
+    // merged from the workers
+    std::map<Names, Entry>  fNamedEntries;
+    std::map<G4String, G4double>  fNamedTracks;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline void EdMedPhProfile::StartTrack(const G4Track* track)
+{
+  AddTrack(track);
+  fLastTime = Clock::now();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline void EdMedPhProfile::EndStep(const G4Step* step)
+{
+  // the map update itself is left out of the next step
+  AddStep(step,
+          std::chrono::duration<G4double>(Clock::now() - fLastTime).count());
+  fLastTime = Clock::now();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,89 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhProgressReporter.hh
+/// \brief Definition of the EdMedPhProgressReporter class
+
+#ifndef EdMedPhProgressReporter_h
+#define EdMedPhProgressReporter_h 1
+
+#include "globals.hh"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+/// Time based run progress reporter
+///
+/// The event loops only count their events with CountEvent(), a relaxed
+/// atomic increment of a per-thread counter on its own cache line.
+/// Between Start() and Stop(), called by the master EdMedPhRunAction, a
+/// background thread samples the counters every interval and prints the
+/// events done, the events/s, the ETA and the per-thread rates.
+
+class EdMedPhProgressReporter
+{
+  public:
+    static EdMedPhProgressReporter* Instance();
+
+    void Start(G4int nofEvents, G4double interval);
+    void Stop();
+
+    // slot 0 is the master (sequential mode), i+1 worker i
+    void CountEvent(G4int slot);
+
+  private:
+    EdMedPhProgressReporter();
+    ~EdMedPhProgressReporter();
+
+    void Report();
+
+    static const G4int kNofSlots = 256;
+
+    struct alignas(64) Slot {
+      std::atomic<G4long>  nofEvents;
+      G4long  lastNofEvents;   // reporter thread only
+    };
+
+    Slot  fSlots[kNofSlots];
+    G4int     fNofEvents;
+    G4double  fInterval;
+
+    std::thread  fThread;
+    std::mutex   fMutex;
+    std::condition_variable  fCondition;
+    G4bool  fStopping;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline void EdMedPhProgressReporter::CountEvent(G4int slot)
+{
+  fSlots[slot % kNofSlots].nofEvents.fetch_add(1, std::memory_order_relaxed);
+}
+
+#endif
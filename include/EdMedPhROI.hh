@@ -0,0 +1,101 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhROI.hh
+/// \brief Definition of the EdMedPhROI classes
+
+#ifndef EdMedPhROI_h
+#define EdMedPhROI_h 1
+
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+
+/// Region of interest for the online dose scoring
+///
+/// A named volume in the coordinates of the step ntuple: X and Y from the
+/// beam axis, Z the depth from the calorimeter entrance face. Deposits
+/// are tested with Contains() by EdMedPhcCalorimeterSD; the volume gives
+/// the dose in the summary written by EdMedPhRunAction. Shapes derive
+/// from this class: EdMedPhSphereROI and EdMedPhBoxROI.
+
+class EdMedPhROI
+{
+  public:
+    EdMedPhROI(const G4String& name) : fName(name) {}
+    virtual ~EdMedPhROI() {}
+
+    virtual G4bool Contains(const G4ThreeVector& position) const = 0;
+    virtual G4double GetVolume() const = 0;
+    virtual G4String GetShape() const = 0;
+
+    const G4String& GetName() const { return fName; }
+
+  private:
+    G4String fName;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class EdMedPhSphereROI : public EdMedPhROI
+{
+  public:
+    EdMedPhSphereROI(const G4String& name, 
+                     const G4ThreeVector& centre, G4double radius);
+
+    virtual G4bool Contains(const G4ThreeVector& position) const
+      { return (position - fCentre).mag2() <= fRadius2; }
+    virtual G4double GetVolume() const;
+    virtual G4String GetShape() const { return "sphere"; }
+
+    void SetCentre(const G4ThreeVector& centre) { fCentre = centre; }
+    void SetRadius(G4double radius) { fRadius = radius; fRadius2 = radius*radius; }
+
+  private:
+    G4ThreeVector fCentre;
+    G4double  fRadius;
+    G4double  fRadius2;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+class EdMedPhBoxROI : public EdMedPhROI
+{
+  public:
+    EdMedPhBoxROI(const G4String& name, 
+                  const G4ThreeVector& centre, const G4ThreeVector& size);
+
+    virtual G4bool Contains(const G4ThreeVector& position) const;
+    virtual G4double GetVolume() const;
+    virtual G4String GetShape() const { return "box"; }
+
+  private:
+    G4ThreeVector fLower;
+    G4ThreeVector fUpper;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -0,0 +1,152 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhRun.hh
+/// \brief Definition of the EdMedPhRun class
+
+#ifndef EdMedPhRun_h
+#define EdMedPhRun_h 1
+
+#include "G4Run.hh"
+#include "G4ThreeVector.hh"
+#include "globals.hh"
+
+#include "EdMedPhDoseGrid.hh"
+#include "EdMedPhProfile.hh"
+
+#include <map>
+#include <vector>
+
+class EdMedPhHitBuffer;
+class EdMedPhROI;
+
+struct EdMedPhThreadLoad
+{
+  G4int     threadId;
+  G4int     nofEvents;
+  G4double  busyTime;    ///< wall time in events [s]
+};
+
+struct EdMedPhProcessHits
+{
+  G4double  nofCalls = 0.;
+  G4double  nofTimedCalls = 0.;
+  G4double  time = 0.;   ///< of the timed calls [ns]
+};
+
+/// Run class
+///
+/// It holds the thread-local quantities scored during a run, which are 
+/// filled directly by EdMedPhcCalorimeterSD and summed into the master run 
+/// in Merge():
+/// - the voxelised energy deposit (EdMedPhDoseGrid)
+/// - the energy deposit in each region of interest, and outside all of
+///   them, with its sum of squares over events: each sensitive detector
+///   adds its share of the event with AddROIEdep(), and the event action
+///   closes the event with EndROIEvent()
+///
+/// It also points to the thread's step ntuple buffer (owned by the run
+/// action, null if the step ntuple is not written) so that the sensitive
+/// detector can pick it up once per event.
+///
+/// The event summary ntuple id (-1 if not written) and the regions of 
+/// interest (owned by the run action, the tumour first) are set by the
+/// run action for the sensitive detector and the event action.
+///
+/// The event action adds the wall time spent in each event with 
+/// AddBusyTime(); Merge() keeps one EdMedPhThreadLoad per worker run so
+/// that the master can report the load balance of the event loops.
+/// Each sensitive detector likewise adds its ProcessHits() calls, and the
+/// time of the sampled ones, with AddProcessHits(), kept per detector.
+///
+/// When profiling is on (SetProfiling()), the run also holds the step
+/// time profile (EdMedPhProfile) filled by the tracking and stepping 
+/// actions; GetProfile() returns null otherwise.
+
+class EdMedPhRun : public G4Run
+{
+  public:
+    EdMedPhRun();
+    virtual ~EdMedPhRun();
+
+    virtual void Merge(const G4Run* run);
+
+    // set methods
+    void SetHitBuffer(EdMedPhHitBuffer* buffer) { fHitBuffer = buffer; }
+    void SetEventNtupleId(G4int id) { fEventNtupleId = id; }
+    void SetROIs(const std::vector<EdMedPhROI*>* rois);
+    void SetProfiling(G4bool value) { fProfiling = value; }
+
+    // add deposits of the current event, per region plus outside all 
+    // regions, then add the event sums and their squares to the run
+    void AddROIEdep(const std::vector<G4double>& edep);
+    void EndROIEvent();
+    void AddBusyTime(G4double time) { fBusyTime += time; }
+    void AddProcessHits(const G4String& detector, G4double nofCalls, 
+                        G4double nofTimedCalls, G4double time);
+
+    // get methods
+    EdMedPhHitBuffer* GetHitBuffer() const { return fHitBuffer; }
+    G4int GetEventNtupleId() const { return fEventNtupleId; }
+    const std::vector<EdMedPhROI*>* GetROIs() const { return fROIs; }
+    // index GetROIs()->size() for the deposits outside all regions
+    G4double GetROIEdep(std::size_t i) const { return fROIEdep[i]; }
+    G4double GetROIEdep2(std::size_t i) const { return fROIEdep2[i]; }
+    G4double GetBusyTime() const { return fBusyTime; }
+    // over all detectors
+    G4double GetNofProcessHits() const;
+    // estimated total time of the ProcessHits() calls [ns]
+    G4double GetProcessHitsTime() const;
+    const std::map<G4String, EdMedPhProcessHits>& GetProcessHits() const
+                                                  { return fProcessHits; }
+    // the worker runs merged into this one
+    const std::vector<EdMedPhThreadLoad>& GetThreadLoads() const 
+                                          { return fThreadLoads; }
+    EdMedPhDoseGrid& GetDoseGrid() { return fDoseGrid; }
+    const EdMedPhDoseGrid& GetDoseGrid() const { return fDoseGrid; }
+    EdMedPhProfile* GetProfile() { return fProfiling ? &fProfile : nullptr; }
+    const EdMedPhProfile* GetProfile() const 
+                          { return fProfiling ? &fProfile : nullptr; }
+
+  private:
+    EdMedPhDoseGrid fDoseGrid;
+    EdMedPhHitBuffer*  fHitBuffer;
+    G4int  fEventNtupleId;
+    const std::vector<EdMedPhROI*>* fROIs;
+    std::vector<G4double>  fROIEdep;
+    std::vector<G4double>  fROIEdep2;
+    std::vector<G4double>  fEventROIEdep;
+    G4int     fThreadId;
+    G4double  fBusyTime;
+    std::vector<EdMedPhThreadLoad>  fThreadLoads;
+    std::map<G4String, EdMedPhProcessHits>  fProcessHits;
+    G4bool    fProfiling;
+    EdMedPhProfile  fProfile;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
@@ -32,9 +32,24 @@
 #define EdMedPhRunAction_h 1
 
 #include "G4UserRunAction.hh"
+#include "G4Accumulable.hh"
+#include "G4ThreeVector.hh"
+#include "G4Timer.hh"
 #include "globals.hh"
 
+#include "EdMedPhHitBuffer.hh"
+#include "EdMedPhPhaseSpaceWriter.hh"
+#include "EdMedPhColumnarWriter.hh"
+
+#include <vector>
+
 class G4Run;
+class EdMedPhRun;
+class EdMedPhProfile;
+class EdMedPhROI;
+class EdMedPhSphereROI;
+class EdMedPhRunMessenger;
+class EdMedPhPrimaryGeneratorAction;
 extern G4String outputFileName;
 /// Run action class
 ///
@@ -53,15 +68,128 @@ extern G4String outputFileName;
 /// In EndOfRunAction(), the accumulated statistic and computed 
 /// dispersion is printed.
 ///
+/// The run itself is an EdMedPhRun, created in GenerateRun() with the 
+/// options set via EdMedPhRunMessenger, which documents the commands.
+/// At the end of the run, the workers flush their step ntuple buffer 
+/// (EdMedPhHitBuffer) and close their phase-space and columnar hit parts,
+/// and the master:
+/// - writes the merged dose map, the region of interest summary and the
+///   dose-volume histograms to <output>_dose.bin, _roi.csv and _dvh.csv,
+/// - concatenates the thread parts, or lists the thread files in 
+///   <output>_manifest.csv when they are not merged,
+/// - prints the run rates, the ProcessHits() cost, the peak RSS, the 
+///   load of each thread and, when profiling, the step time profile.
+///
+/// BeamOn() runs the share of the events of a job split in shards. 
+/// The outputs and the commands are described in the README.
 
 class EdMedPhRunAction : public G4UserRunAction
 {
   public:
-    EdMedPhRunAction();
+    EdMedPhRunAction(
+      EdMedPhPrimaryGeneratorAction* primaryGenerator = nullptr);
     virtual ~EdMedPhRunAction();
 
+    virtual G4Run* GenerateRun();
     virtual void BeginOfRunAction(const G4Run*);
     virtual void   EndOfRunAction(const G4Run*);
+
+    // set methods
+    void SetFillStepNtuple(G4bool value) { fFillStepNtuple = value; }
+    void SetHitBufferSize(G4int value)   { fHitBufferSize = value; }
+    // only before the first run
+    void SetMergeThreadFiles(G4bool value);
+    void SetColumnarOutput(G4bool value) { fColumnarOutput = value; }
+    void SetColumnarCodec(G4int value)   { fColumnarCodec = value; }
+    void SetColumnarQuantum(G4double value) { fColumnarQuantum = value; }
+    void SetFillEventNtuple(G4bool value) { fFillEventNtuple = value; }
+    void SetTumourCentre(const G4ThreeVector& value);
+    void SetTumourRadius(G4double value);
+    void AddSphereROI(const G4String& name, 
+                      const G4ThreeVector& centre, G4double radius);
+    void AddBoxROI(const G4String& name, 
+                   const G4ThreeVector& centre, const G4ThreeVector& size);
+    void ClearROIs();
+    void SetDoseScoring(G4bool value)    { fDoseScoring = value; }
+    void SetDoseBins(G4int nx, G4int ny, G4int nz);
+    void SetDoseSize(const G4ThreeVector& size) { fDoseSize = size; }
+    void SetDVHBins(G4int value) { fDVHBins = value; }
+    void SetPhaseSpaceFile(const G4String& fileName);
+    void SetPhaseSpaceAtPlane(G4bool value) { fPhaseSpaceAtPlane = value; }
+    void SetPhaseSpacePlaneOffset(G4double value) 
+           { fPhaseSpacePlaneOffset = value; }
+
+    void SetProgressInterval(G4double value) { fProgressInterval = value; }
+    void SetShard(G4int index, G4int count);
+    void SetProfiling(G4bool value) { fProfiling = value; }
+    void BeamOn(G4int nofEvents);
+    void CountStep() { ++fThreadSteps; }
+
+    // get methods
+    EdMedPhPhaseSpaceWriter* GetPlaneWriter() const { return fPlaneWriter; }
+    G4double GetPlaneZ() const { return fPlaneZ; }
+    // the profile of the current run, null when not profiling
+    EdMedPhProfile* GetProfile() const { return fProfile; }
+
+  private:
+    void BookNtuples();
+    G4String GetPhaseSpacePartFile(G4int threadId) const;
+    G4String GetColumnarFile(G4int threadId = -1) const;
+    std::vector<G4String> GetPartFiles(const EdMedPhRun* run, 
+                                       const G4String& fileName) const;
+    G4double GetStepFileBytes() const;
+    void ResolvePlane();
+    void WriteROISummary(const EdMedPhRun* run) const;
+    void WriteDVHs(const EdMedPhRun* run) const;
+    void WriteManifest() const;
+    void PrintThreadLoads(const EdMedPhRun* run, G4double wallTime) const;
+    void PrintProfile(const EdMedPhRun* run) const;
+
+    EdMedPhPrimaryGeneratorAction*  fPrimaryGenerator;
+    EdMedPhRunMessenger*  fMessenger;
+    G4String  fFileName;
+
+    G4bool    fFillStepNtuple;
+    G4int     fHitBufferSize;
+    EdMedPhHitBuffer  fHitBuffer;
+    G4bool    fMergeThreadFiles;
+    G4bool    fNtuplesBooked;
+    G4bool    fColumnarOutput;
+    G4int     fColumnarCodec;
+    G4double  fColumnarQuantum;
+    EdMedPhColumnarWriter  fColumnarWriter;
+    G4Accumulable<G4double>  fColumnarRawBytes;
+    G4Accumulable<G4double>  fColumnarBytes;
+    G4Accumulable<G4double>  fNtupleRows;
+    G4Accumulable<G4double>  fNtupleFlushTime;
+
+    G4bool    fFillEventNtuple;
+    G4int     fEventNtupleId;
+    EdMedPhSphereROI*  fTumour;
+    std::vector<EdMedPhROI*>  fROIs;      // fTumour first
+
+    G4Timer   fTimer;
+    G4double  fThreadSteps;
+    G4Accumulable<G4double>  fNofSteps;
+    G4double  fProgressInterval;
+
+    G4bool    fDoseScoring;
+    G4int     fDoseBins[3];
+    G4ThreeVector  fDoseSize;
+    G4int     fDVHBins;
+
+    G4String  fPhaseSpaceFileName;
+    G4bool    fPhaseSpaceAtPlane;
+    G4double  fPhaseSpacePlaneOffset;
+    EdMedPhPhaseSpaceWriter  fPhaseSpaceWriter;
+    EdMedPhPhaseSpaceWriter* fPlaneWriter;  // set when recording at the plane
+    G4double  fPlaneZ;
+
+    G4int     fShardIndex;
+    G4int     fNofShards;
+
+    G4bool    fProfiling;
+    EdMedPhProfile*  fProfile;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
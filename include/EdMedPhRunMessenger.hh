@@ -0,0 +1,117 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhRunMessenger.hh
+/// \brief Definition of the EdMedPhRunMessenger class
+
+#ifndef EdMedPhRunMessenger_h
+#define EdMedPhRunMessenger_h 1
+
+#include "G4UImessenger.hh"
+#include "globals.hh"
+
+class EdMedPhRunAction;
+class G4UIdirectory;
+class G4UIcommand;
+class G4UIcmdWithABool;
+class G4UIcmdWithAnInteger;
+class G4UIcmdWith3VectorAndUnit;
+class G4UIcmdWithAString;
+class G4UIcmdWithADoubleAndUnit;
+class G4UIcmdWithoutParameter;
+
+/// Messenger class for the run-level scoring and output options
+///
+/// It defines the following commands:
+/// - /EdMedPh/output/stepNtuple  true|false
+/// - /EdMedPh/output/hitBufferSize  rows
+/// - /EdMedPh/output/eventNtuple true|false
+/// - /EdMedPh/tumour/centre      x y depth unit
+/// - /EdMedPh/tumour/radius      radius unit
+/// - /EdMedPh/roi/sphere         name x y depth radius unit
+/// - /EdMedPh/roi/box            name x y depth sx sy sz unit
+/// - /EdMedPh/roi/clear
+/// - /EdMedPh/dose/scoring       true|false
+/// - /EdMedPh/dose/bins          nx ny nz
+/// - /EdMedPh/dose/size          sx sy sz unit
+/// - /EdMedPh/dose/dvhBins       nBins
+/// - /EdMedPh/phsp/file          fileName|none
+/// - /EdMedPh/phsp/source        primaries|plane
+/// - /EdMedPh/phsp/planeOffset   distance unit
+/// - /EdMedPh/progress/interval  time unit
+/// - /EdMedPh/run/shard          index count
+/// - /EdMedPh/run/beamOn         nofEvents
+/// - /EdMedPh/profile/enable     true|false
+
+class EdMedPhRunMessenger: public G4UImessenger
+{
+  public:
+    EdMedPhRunMessenger(EdMedPhRunAction* runAction);
+    virtual ~EdMedPhRunMessenger();
+
+    virtual void SetNewValue(G4UIcommand* command, G4String newValue);
+
+  private:
+    EdMedPhRunAction*  fRunAction;
+
+    G4UIdirectory*     fTopDirectory;
+    G4UIdirectory*     fOutputDirectory;
+    G4UIdirectory*     fTumourDirectory;
+    G4UIdirectory*     fROIDirectory;
+    G4UIdirectory*     fDoseDirectory;
+    G4UIdirectory*     fPhaseSpaceDirectory;
+    G4UIdirectory*     fProgressDirectory;
+    G4UIdirectory*     fRunDirectory;
+    G4UIdirectory*     fProfileDirectory;
+
+    G4UIcmdWithABool*  fStepNtupleCmd;
+    G4UIcmdWithAnInteger*  fHitBufferSizeCmd;
+    G4UIcmdWithAString*  fStepFormatCmd;
+    G4UIcmdWithABool*  fMergeThreadFilesCmd;
+    G4UIcmdWithAString*  fCodecCmd;
+    G4UIcmdWithADoubleAndUnit*  fQuantumCmd;
+    G4UIcmdWithABool*  fEventNtupleCmd;
+    G4UIcmdWith3VectorAndUnit* fTumourCentreCmd;
+    G4UIcmdWithADoubleAndUnit* fTumourRadiusCmd;
+    G4UIcommand*       fSphereROICmd;
+    G4UIcommand*       fBoxROICmd;
+    G4UIcmdWithoutParameter*  fClearROIsCmd;
+    G4UIcmdWithABool*  fDoseScoringCmd;
+    G4UIcommand*       fDoseBinsCmd;
+    G4UIcmdWith3VectorAndUnit* fDoseSizeCmd;
+    G4UIcmdWithAnInteger*  fDVHBinsCmd;
+    G4UIcmdWithAString*  fPhaseSpaceFileCmd;
+    G4UIcmdWithAString*  fPhaseSpaceSourceCmd;
+    G4UIcmdWithADoubleAndUnit*  fPlaneOffsetCmd;
+    G4UIcmdWithADoubleAndUnit*  fProgressIntervalCmd;
+    G4UIcommand*       fShardCmd;
+    G4UIcmdWithAnInteger*  fBeamOnCmd;
+    G4UIcmdWithABool*  fProfileCmd;
+};
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+#endif
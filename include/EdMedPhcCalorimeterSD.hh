@@ -44,15 +44,42 @@
 
 class G4Step;
 class G4HCofThisEvent;
+class EdMedPhDoseGrid;
+class EdMedPhHitBuffer;
+class EdMedPhRun;
+class EdMedPhROI;
 
 
 /// Calorimeter sensitive detector class
 ///
-/// In Initialize(), it creates one hit for each calorimeter layer and one more
-/// hit for accounting the total quantities in all layers.
+/// The energy deposit and charged track length are summed per calorimeter 
+/// layer in flat arrays, with one more entry for the total quantities in 
+/// all layers. The arrays are reused and only zeroed in Initialize(), 
+/// and read by EdMedPhcEventAction with the get methods.
+/// Only when SetExportHits() is set, they are copied in EndOfEvent() to
+/// a hits collection of EdMedPhcCalorHit, one hit per layer plus the total
+/// one, for code reading the event's hits collections.
 ///
-/// The values are accounted in hits in ProcessHits() function which is called
-/// by Geant4 kernel at each step.
+/// The values are accounted in ProcessHits() function which is called
+/// by Geant4 kernel at each step. The energy deposit of each step is also
+/// binned directly into the dose grid of the current EdMedPhRun and, only
+/// if requested, appended to the step ntuple buffer (EdMedPhHitBuffer).
+///
+/// The energy deposited in each region of interest of the current 
+/// EdMedPhRun, and outside all of them, is summed per event as well and
+/// added to the run's event sums in EndOfEvent(), where the deposits of
+/// all detectors meet; region 0 is the tumour of the event summary.
+///
+/// Depths are measured from the calorimeter entrance face (SetEntranceZ()).
+/// In the layered geometry the cell is the replica number of the layer;
+/// in the solid phantom it is computed from the depth, in bins of 
+/// SetCellWidth(), so the cells act as a readout grid without geometric
+/// boundaries.
+///
+/// One ProcessHits() call in kTimingStride is timed, which costs little
+/// enough to stay on; the calls and the sampled time are added to the
+/// run, under the detector name, in EndOfEvent() for the ns/call figure
+/// printed at the end of run.
 
 class EdMedPhcCalorimeterSD : public G4VSensitiveDetector
 {
@@ -67,9 +94,48 @@ class EdMedPhcCalorimeterSD : public G4VSensitiveDetector
     virtual G4bool ProcessHits(G4Step* step, G4TouchableHistory* history);
     virtual void   EndOfEvent(G4HCofThisEvent* hitCollection);
 
+    // set methods
+    void SetNofCells(G4int value)     { fNofCells = value; }
+    void SetEntranceZ(G4double value) { fEntranceZ = value; }
+    void SetCellWidth(G4double value) { fCellWidth = value; }
+    void SetExportHits(G4bool value)  { fExportHits = value; }
+
+    // get methods, valid at the end of the event
+    G4int    GetNofCells() const { return fNofCells; }
+    G4double GetEdep(G4int cell) const { return fEdep[cell]; }
+    G4double GetTrackLength(G4int cell) const { return fTrackLength[cell]; }
+    G4double GetTotalEdep() const { return fEdep[fNofCells]; }
+    G4double GetTotalTrackLength() const { return fTrackLength[fNofCells]; }
+    G4double GetTumourEdep() const 
+               { return fROIEdep.size() > 1 ? fROIEdep[0] : 0.; }
+
   private:
-    EdMedPhcCalorHitsCollection* fHitsCollection;
+    G4bool ScoreStep(G4Step* step);
+
+    static const G4int kTimingStride = 64;
+
     G4int  fNofCells;
+    std::vector<G4double>  fEdep;          // fNofCells + total
+    std::vector<G4double>  fTrackLength;   // fNofCells + total
+    G4bool  fExportHits;
+    G4int   fHCID;
+    G4double  fEntranceZ;
+    G4double  fCellWidth;  // 0 when the cells are replicas
+
+    // cached once per event in Initialize()
+    EdMedPhDoseGrid*  fDoseGrid;
+    EdMedPhHitBuffer* fHitBuffer;
+    G4int   fEventID;
+    EdMedPhRun*  fRun;
+    const std::vector<EdMedPhROI*>* fROIs;
+
+    std::vector<G4double>  fROIEdep;       // regions + outside
+
+    // ProcessHits() calls of the event, and of them the timed ones
+    G4int     fNofCalls;
+    G4int     fNofTimedCalls;
+    G4double  fTimedCallsTime;  // [ns]
+    unsigned int  fTimingCounter;
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
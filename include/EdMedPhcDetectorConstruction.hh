@@ -34,8 +34,14 @@
 #include "G4VUserDetectorConstruction.hh"
 #include "globals.hh"
 
+#include "EdMedPhCTPhantom.hh"
+
 class G4VPhysicalVolume;
 class G4GlobalMagFieldMessenger;
+class G4LogicalVolume;
+class G4Material;
+class G4PhantomParameterisation;
+class EdMedPhDetectorMessenger;
 
 /// Detector construction class to define materials and geometry.
 /// The calorimeter is a box made of a given number of layers. A layer consists
@@ -48,34 +54,107 @@ class G4GlobalMagFieldMessenger;
 /// - the number of layers,
 /// - the transverse size of the calorimeter (the input face is a square).
 ///
-/// In ConstructSDandField() sensitive detectors of EdMedPhcCalorimeterSD type
-/// are created and associated with the Absorber and Gap volumes.
+/// They, the absorber and gap materials and the geometry mode can be changed
+/// between runs with the /EdMedPh/det/ commands (EdMedPhDetectorMessenger).
+/// The geometry modes are:
+/// - layered: the replicated absorber/gap layers described above,
+/// - solid:   a single absorber of the same depth, without gaps; 
+///            the layers are then a readout binning of the sensitive 
+///            detector and no longer step boundaries;
+/// - ct:      a voxelised CT phantom read from /EdMedPh/det/ctFile 
+///            (EdMedPhCTPhantom), built with G4PhantomParameterisation;
+///            the voxels have the "AbsoLV" logical volume and the z slices
+///            are the scoring cells. With /EdMedPh/det/regularNavigation
+///            (default true) the navigator uses the regular structure 
+///            algorithm, which skips the boundaries between voxels of
+///            equal material.
+///
+/// Only what changed is rebuilt: a new material is set in place in the
+/// existing logical volumes (the physics tables are then rebuilt), while
+/// a new size or mode requests a geometry reinitialisation, and Construct()
+/// then replaces the volumes. Construct() returns the current world as is
+/// when nothing changed, e.g. on an explicit /run/reinitializeGeometry.
+/// The sensitive detectors and field messenger are reused.
+///
+/// In ConstructSDandField() a sensitive detector of EdMedPhcCalorimeterSD type
+/// is created and associated with the Absorber volume; a second one for the
+/// Gap volume is created only with /EdMedPh/det/gapSD true. With 
+/// /EdMedPh/det/exportHits true they also fill their hits collections.
 /// In addition a transverse uniform magnetic field is defined 
 /// via G4GlobalMagFieldMessenger class.
 
 class EdMedPhcDetectorConstruction : public G4VUserDetectorConstruction
 {
   public:
+    enum GeometryMode { kLayered, kSolid, kCT };
+
     EdMedPhcDetectorConstruction();
     virtual ~EdMedPhcDetectorConstruction();
 
   public:
     virtual G4VPhysicalVolume* Construct();
     virtual void ConstructSDandField();
+
+    // set methods
+    void SetGeometryMode(GeometryMode mode);
+    void SetNofLayers(G4int value);
+    void SetAbsoThickness(G4double value);
+    void SetGapThickness(G4double value);
+    void SetCalorSizeXY(G4double value);
+    void SetAbsorberMaterial(const G4String& name);
+    void SetGapMaterial(const G4String& name);
+    void SetCTFile(const G4String& fileName);
+    void SetRegularNavigation(G4bool value);
+    void SetGapSD(G4bool value)      { fGapSD = value; }
+    void SetExportHits(G4bool value) { fExportHits = value; }
+
+    // get methods
+    GeometryMode GetGeometryMode() const { return fGeometryMode; }
      
   private:
     // methods
     //
     void DefineMaterials();
+    G4Material* FindMaterial(const G4String& name) const;
+    void GeometryHasChanged();
     G4VPhysicalVolume* DefineVolumes();
+    void DefineLayers(G4LogicalVolume* calorLV, G4Material* defaultMaterial,
+                      G4Material* absorberMaterial, G4Material* gapMaterial);
+    void DefineSolidPhantom(G4LogicalVolume* calorLV, 
+                            G4Material* absorberMaterial);
+    void DefineCTPhantom(G4VPhysicalVolume* calorPV);
   
     // data members
     //
     static G4ThreadLocal G4GlobalMagFieldMessenger*  fMagFieldMessenger; 
                                       // magnetic field messenger
 
+    EdMedPhDetectorMessenger*  fMessenger;
+
     G4bool  fCheckOverlaps; // option to activate checking of volumes overlaps
+    GeometryMode  fGeometryMode;
     G4int   fNofLayers;     // number of layers
+    G4double  fAbsoThickness;
+    G4double  fGapThickness;
+    G4double  fCalorSizeXY;
+    G4double  fCalorThickness;
+    G4int     fNofCells;      // scoring cells along z
+    G4double  fCellWidth;     // 0 when the cells are replicas
+    G4Material*  fAbsorberMaterial;
+    G4Material*  fGapMaterial;
+
+    G4bool  fGeometryChanged;         // since the last Construct()
+    G4VPhysicalVolume*  fWorldPV;
+    G4LogicalVolume*    fAbsorberLV;
+    G4LogicalVolume*    fGapLV;       // null in the solid phantom
+
+    G4String  fCTFileName;
+    G4bool    fRegularNavigation;
+    EdMedPhCTPhantom  fCTPhantom;
+    G4PhantomParameterisation*  fCTParameterisation;
+
+    G4bool  fGapSD;           // score the gaps too
+    G4bool  fExportHits;      // fill the hits collections
 };
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -32,16 +32,22 @@
 #define EdMedPhcEventAction_h 1
 
 #include "G4UserEventAction.hh"
-
-#include "EdMedPhcCalorHit.hh"
+#include "G4Timer.hh"
 
 #include "globals.hh"
 
+class EdMedPhcCalorimeterSD;
+
 /// Event action class
 ///
 /// In EndOfEventAction(), it prints the accumulated quantities of the energy 
-/// deposit and track lengths of charged particles in Absober and Gap layers 
-/// stored in the hits collections.
+/// deposit and track lengths of charged particles in Absober layers, read
+/// from the per-layer sums of the absorber EdMedPhcCalorimeterSD, every 
+/// /run/printProgress events (off by default), and counts the event for 
+/// EdMedPhProgressReporter.
+/// When the current EdMedPhRun has an event ntuple, it also adds one row
+/// with the absorber totals, the tumour deposit and the primary energy.
+/// The wall time of each event is added to the run's busy time.
 
 class EdMedPhcEventAction : public G4UserEventAction
 {
@@ -54,13 +60,12 @@ public:
     
 private:
   // methods
-  EdMedPhcCalorHitsCollection* GetHitsCollection(G4int hcID,
-                                            const G4Event* event) const;
   void PrintEventStatistics(G4double absoEdep, G4double absoTrackLength) const;
   
   // data members                   
-  G4int  fAbsHCID;
-  G4int  fGapHCID;
+  EdMedPhcCalorimeterSD*  fAbsoSD;
+  G4int  fProgressSlot;
+  G4Timer  fEventTimer;
 };
                      
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -1,28 +1,44 @@
 #!/bin/bash
-pid_counter=0
+# Analyse datasets/<particle>.root for the given particles 
+# (gammas and neutrons by default) and collect the outputs.
+#
+# EdMedPhc_analysis (built with ROOT, see analysis/) reads each dataset
+# once for all the stages of the ROOT macros and the particles in 
+# parallel; set EDMEDPH_ANALYSIS to its path if it is not in ./build.
+# Without it the macros are run as separate root processes.
+
+ANALYSIS=${EDMEDPH_ANALYSIS:-build/EdMedPhc_analysis}
 
 if [[ $# == 0 ]]; then
     PARTICLES="gammas neutrons"
-    echo "Running plot_same"
-    root root_macros/plot_same.C 1> /dev/null &   pids[$((pid_counter++))]=$!
 else
     PARTICLES=$*
 fi
 
-for PARTICLE in $PARTICLES; do
-    echo "Running analyse_dose for $PARTICLE"
-    root "root_macros/analyse_dose.C(\"$PARTICLE\")" 1> /dev/null &  pids[$((pid_counter++))]=$!
-    echo "Running make_histos for $PARTICLE"
-    root "root_macros/make_histos.C(\"$PARTICLE\")" 1> /dev/null &  pids[$((pid_counter++))]=$!
-    echo "Running edit_histo for $PARTICLE"
-    root "root_macros/edit_histo.C(60,\"$PARTICLE\")" 1> /dev/null &    pids[$((pid_counter++))]=$!    
-done
+if [ -x "$ANALYSIS" ]; then
+    echo "Running $ANALYSIS for $PARTICLES"
+    "$ANALYSIS" $PARTICLES -x 60 1> /dev/null || exit 1
+else
+    pid_counter=0
+    if [[ $# == 0 ]]; then
+        echo "Running plot_same"
+        root root_macros/plot_same.C 1> /dev/null &   pids[$((pid_counter++))]=$!
+    fi
 
+    for PARTICLE in $PARTICLES; do
+        echo "Running analyse_dose for $PARTICLE"
+        root "root_macros/analyse_dose.C(\"$PARTICLE\")" 1> /dev/null &  pids[$((pid_counter++))]=$!
+        echo "Running make_histos for $PARTICLE"
+        root "root_macros/make_histos.C(\"$PARTICLE\")" 1> /dev/null &  pids[$((pid_counter++))]=$!
+        echo "Running edit_histo for $PARTICLE"
+        root "root_macros/edit_histo.C(60,\"$PARTICLE\")" 1> /dev/null &    pids[$((pid_counter++))]=$!    
+    done
 
-# wait for all pids
-for pid in ${pids[*]}; do
-    wait $pid
-done
+    # wait for all pids
+    for pid in ${pids[*]}; do
+        wait $pid
+    done
+fi
 
 mkdir -p figures
 for PARTICLE in $PARTICLES; do
@@ -0,0 +1,88 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhAliasTable.cc
+/// \brief Implementation of the EdMedPhAliasTable class
+
+#include "EdMedPhAliasTable.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhAliasTable::EdMedPhAliasTable()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhAliasTable::~EdMedPhAliasTable()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhAliasTable::Build(const std::vector<G4double>& weights)
+{
+  G4int n = weights.size();
+  G4double sum = 0.;
+  for ( auto w : weights ) sum += w;
+
+  if ( n == 0 || sum <= 0. ) {
+    G4ExceptionDescription msg;
+    msg << "Cannot build an alias table from " << n << " bins" 
+        << " of total weight " << sum; 
+    G4Exception("EdMedPhAliasTable::Build()",
+      "MyCode0008", FatalException, msg);
+    return;
+  }
+
+  fProbability.resize(n);
+  fAlias.resize(n);
+
+  // Scale the weights so that their mean is 1 and split the bins
+  // into under- and over-full ones
+  std::vector<G4double> scaled(n);
+  std::vector<G4int> small, large;
+  for ( G4int i=0; i<n; i++ ) {
+    scaled[i] = weights[i]*n/sum;
+    if ( scaled[i] < 1. ) small.push_back(i);
+    else                  large.push_back(i);
+  }
+
+  // Fill each under-full bin with the excess of an over-full one
+  while ( ! small.empty() && ! large.empty() ) {
+    auto s = small.back(); small.pop_back();
+    auto l = large.back(); large.pop_back();
+    fProbability[s] = scaled[s];
+    fAlias[s] = l;
+    scaled[l] -= 1. - scaled[s];
+    if ( scaled[l] < 1. ) small.push_back(l);
+    else                  large.push_back(l);
+  }
+
+  // What is left is full up to rounding errors
+  for ( auto i : large ) { fProbability[i] = 1.; fAlias[i] = i; }
+  for ( auto i : small ) { fProbability[i] = 1.; fAlias[i] = i; }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
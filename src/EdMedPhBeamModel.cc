@@ -0,0 +1,146 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhBeamModel.cc
+/// \brief Implementation of the EdMedPhBeamModel class
+
+#include "EdMedPhBeamModel.hh"
+
+#include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+
+#include <cmath>
+
+namespace {
+  // Range of the discretised standard normal distribution
+  const G4double kNormalRange = 5.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhBeamModel::EdMedPhBeamModel()
+ : fEnergySpread(0.),
+   fSpotSize(0.),
+   fDivergence(0.),
+   fTableBins(1000),
+   fNormalBinWidth(0.)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhBeamModel::~EdMedPhBeamModel()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhBeamModel::AddLayer(G4double energy, G4double weight)
+{
+  fLayerEnergies.push_back(energy);
+  fLayerWeights.push_back(weight);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhBeamModel::ClearLayers()
+{
+  fLayerEnergies.clear();
+  fLayerWeights.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhBeamModel::BuildTables()
+{
+  // Standard normal distribution: probability of each bin over +-5 sigma
+  //
+  fNormalBinWidth = 2.*kNormalRange/fTableBins;
+  std::vector<G4double> weights(fTableBins);
+  for ( G4int i=0; i<fTableBins; i++ ) {
+    G4double lower = -kNormalRange + i*fNormalBinWidth;
+    G4double upper = lower + fNormalBinWidth;
+    weights[i] = std::erf(upper/std::sqrt(2.)) - std::erf(lower/std::sqrt(2.));
+  }
+  fNormalTable.Build(weights);
+
+  // Spread-out Bragg peak layers
+  //
+  if ( ! fLayerWeights.empty() ) {
+    fLayerTable.Build(fLayerWeights);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+inline G4double 
+EdMedPhBeamModel::SampleNormal(CLHEP::HepRandomEngine* engine) const
+{
+  auto bin = fNormalTable.Sample(engine->flat());
+  return -kNormalRange + (bin + engine->flat())*fNormalBinWidth;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhBeamModel::Sample(CLHEP::HepRandomEngine* engine,
+                              G4double nominalEnergy, 
+                              const G4ThreeVector& axis,
+                              G4ThreeVector& position, 
+                              G4ThreeVector& direction,
+                              G4double& energy) const
+{
+  // Energy: layer, then spread
+  //
+  energy = nominalEnergy;
+  if ( ! fLayerEnergies.empty() ) {
+    energy = fLayerEnergies[fLayerTable.Sample(engine->flat())];
+  }
+  if ( fEnergySpread > 0. ) {
+    G4double sampled;
+    do {
+      sampled = energy + fEnergySpread*SampleNormal(engine);
+    } while ( sampled <= 0. );
+    energy = sampled;
+  }
+
+  // Spot position, relative to the nominal one
+  //
+  position = G4ThreeVector();
+  if ( fSpotSize > 0. ) {
+    position.setX(fSpotSize*SampleNormal(engine));
+    position.setY(fSpotSize*SampleNormal(engine));
+  }
+
+  // Direction around the beam axis
+  //
+  direction = axis;
+  if ( fDivergence > 0. ) {
+    G4double thetaX = fDivergence*SampleNormal(engine);
+    G4double thetaY = fDivergence*SampleNormal(engine);
+    direction = G4ThreeVector(std::tan(thetaX), std::tan(thetaY), 1.).unit();
+    direction.rotateUz(axis);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,137 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhCTPhantom.cc
+/// \brief Implementation of the EdMedPhCTPhantom class
+
+#include "EdMedPhCTPhantom.hh"
+#include "EdMedPhCTFormat.hh"
+
+#include "G4Material.hh"
+#include "G4NistManager.hh"
+#include "G4SystemOfUnits.hh"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhCTPhantom::EdMedPhCTPhantom()
+{
+  fNofVoxels[0] = fNofVoxels[1] = fNofVoxels[2] = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhCTPhantom::~EdMedPhCTPhantom()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool EdMedPhCTPhantom::Read(const G4String& fileName)
+{
+  G4ExceptionDescription msg;
+
+  std::ifstream file(fileName, std::ios::binary);
+  EdMedPhCTHeader header;
+  if ( ! file.read(reinterpret_cast<char*>(&header), sizeof(header)) 
+       || std::memcmp(header.magic, "EDMPCT01", 8) != 0 ) {
+    msg << fileName << " is not a CT phantom file";
+  }
+  else if ( header.nx <= 0 || header.ny <= 0 || header.nz <= 0 
+            || header.nofMaterials <= 0 
+            || header.nofMaterials > 65536 ) {
+    msg << "Invalid CT phantom dimensions in " << fileName;
+  }
+
+  // materials
+  std::vector<G4Material*> materials;
+  auto nistManager = G4NistManager::Instance();
+  for ( G4int i = 0; msg.str().empty() && i < header.nofMaterials; ++i ) {
+    EdMedPhCTMaterial entry;
+    if ( ! file.read(reinterpret_cast<char*>(&entry), sizeof(entry)) ) {
+      msg << "CT phantom file " << fileName << " is truncated";
+      break;
+    }
+    G4String baseName(entry.name, strnlen(entry.name, sizeof(entry.name)));
+    std::ostringstream name;
+    name << baseName << "_" << entry.density;
+    auto material = G4Material::GetMaterial(name.str(), false);
+    if ( ! material ) {
+      material = nistManager->BuildMaterialWithNewDensity(
+                   name.str(), baseName, entry.density*g/cm3);
+    }
+    if ( ! material ) {
+      msg << "Unknown NIST material " << baseName << " in " << fileName;
+      break;
+    }
+    materials.push_back(material);
+  }
+
+  // material indices
+  std::size_t nofVoxels 
+    = std::size_t(header.nx)*std::size_t(header.ny)*std::size_t(header.nz);
+  std::vector<std::uint16_t> indices;
+  if ( msg.str().empty() ) {
+    indices.resize(nofVoxels);
+    if ( ! file.read(reinterpret_cast<char*>(indices.data()), 
+                     nofVoxels*sizeof(std::uint16_t)) ) {
+      msg << "CT phantom file " << fileName << " is truncated";
+    }
+  }
+  if ( msg.str().empty() ) {
+    auto maxIndex = *std::max_element(indices.begin(), indices.end());
+    if ( maxIndex >= materials.size() ) {
+      msg << "Material index " << maxIndex << " out of range in " 
+          << fileName;
+    }
+  }
+
+  if ( ! msg.str().empty() ) {
+    G4Exception("EdMedPhCTPhantom::Read()",
+      "MyCode0013", FatalException, msg);
+    return false;
+  }
+
+  fNofVoxels[0] = header.nx;
+  fNofVoxels[1] = header.ny;
+  fNofVoxels[2] = header.nz;
+  fVoxelSize.set(header.voxelSize[0]*mm, header.voxelSize[1]*mm, 
+                 header.voxelSize[2]*mm);
+  fMaterials = materials;
+  fMaterialIndices.assign(indices.begin(), indices.end());
+
+  G4cout << " CT phantom " << fileName << " : " 
+         << fNofVoxels[0] << " x " << fNofVoxels[1] << " x " << fNofVoxels[2] 
+         << " voxels of " << fVoxelSize/mm << " mm, " 
+         << fMaterials.size() << " materials" << G4endl;
+
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
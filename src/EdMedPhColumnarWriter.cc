@@ -0,0 +1,247 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhColumnarWriter.cc
+/// \brief Implementation of the EdMedPhColumnarWriter class
+
+#include "EdMedPhColumnarWriter.hh"
+
+#include "G4SystemOfUnits.hh"
+#include "G4UnitsTable.hh"
+
+#include <cstdio>
+#include <cstring>
+
+namespace {
+  const char kMagic[8] = { 'E', 'D', 'M', 'P', 'C', 'O', 'L', '1' };
+  const char kPadding[EdMedPhColumnar::kAlignment] = {};
+
+  EdMedPhColumnarHeader MakeHeader()
+  {
+    EdMedPhColumnarHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.nofColumns = EdMedPhColumnar::kNofColumns;
+    return header;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhColumnarWriter::EdMedPhColumnarWriter()
+ : fNofRows(0),
+   fNofChunks(0),
+   fCodec(EdMedPhColumnar::kRaw),
+   fQuantum(0.01),
+   fRawBytes(0.),
+   fWrittenBytes(0.)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhColumnarWriter::~EdMedPhColumnarWriter()
+{
+  Close();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhColumnarWriter::SetCodec(G4int codec, G4double quantum,
+                                     G4double maxPosition)
+{
+  if ( codec == EdMedPhColumnar::kPackedZlib 
+       && ! EdMedPhColumnar::HasZlib() ) {
+    G4ExceptionDescription msg;
+    msg << "Built without zlib, the hit columns are only packed"; 
+    G4Exception("EdMedPhColumnarWriter::SetCodec()",
+      "MyCode0015", JustWarning, msg);
+    codec = EdMedPhColumnar::kPacked;
+  }
+  fCodec = codec;
+  fQuantum = quantum/mm;
+
+  // the quantized positions up to maxPosition must fit in an int32
+  auto minQuantum = maxPosition/mm/EdMedPhColumnar::kMaxQuantumSteps;
+  if ( fCodec != EdMedPhColumnar::kRaw && fQuantum < minQuantum ) {
+    fQuantum = minQuantum;
+    G4ExceptionDescription msg;
+    msg << "Quantum of " << G4BestUnit(quantum, "Length") 
+        << " too small for positions up to " 
+        << G4BestUnit(maxPosition, "Length") << "," << G4endl;
+    msg << "the positions are packed in steps of " << fQuantum << " mm";
+    G4Exception("EdMedPhColumnarWriter::SetCodec()",
+      "MyCode0015", JustWarning, msg);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool EdMedPhColumnarWriter::Open(const G4String& fileName)
+{
+  Close();
+
+  fFile.open(fileName, std::ios::binary | std::ios::trunc);
+  if ( ! fFile ) {
+    G4ExceptionDescription msg;
+    msg << "Cannot open columnar hit file " << fileName; 
+    G4Exception("EdMedPhColumnarWriter::Open()",
+      "MyCode0015", JustWarning, msg);
+    return false;
+  }
+
+  // header, the counts are patched in Close()
+  auto header = MakeHeader();
+  fFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  fNofRows = 0;
+  fNofChunks = 0;
+  fRawBytes = 0.;
+  fWrittenBytes = sizeof(header);
+
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhColumnarWriter::Close()
+{
+  if ( ! fFile.is_open() ) return;
+
+  fFile.seekp(offsetof(EdMedPhColumnarHeader, nofRows));
+  fFile.write(reinterpret_cast<const char*>(&fNofRows), sizeof(fNofRows));
+  fFile.write(reinterpret_cast<const char*>(&fNofChunks), 
+              sizeof(fNofChunks));
+  fFile.close();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhColumnarWriter::WriteChunk(std::size_t nofRows, 
+                                       const float* edep, const float* x, 
+                                       const float* y, const float* z,
+                                       const std::int32_t* eventID)
+{
+  if ( nofRows == 0 || ! fFile.is_open() ) return;
+
+  EdMedPhColumnarChunk chunk;
+  std::memset(&chunk, 0, sizeof(chunk));
+  chunk.nofRows = nofRows;
+  chunk.codec = fCodec;
+  chunk.quantum = fQuantum;
+
+  if ( fCodec != EdMedPhColumnar::kRaw 
+       && ! EdMedPhColumnar::EncodeChunk(fCodec, fQuantum, nofRows, 
+                                         edep, x, y, z, eventID, fColumns) ) {
+    G4ExceptionDescription msg;
+    msg << "Cannot encode a chunk of " << nofRows << " hits, written raw"; 
+    G4Exception("EdMedPhColumnarWriter::WriteChunk()",
+      "MyCode0015", JustWarning, msg);
+    chunk.codec = EdMedPhColumnar::kRaw;
+  }
+
+  // in EdMedPhColumnar::Column order
+  if ( chunk.codec == EdMedPhColumnar::kRaw ) {
+    for ( auto& columnBytes : chunk.columnBytes ) {
+      columnBytes = nofRows*EdMedPhColumnar::kBytesPerValue;
+    }
+    fFile.write(reinterpret_cast<const char*>(&chunk), sizeof(chunk));
+    WriteColumn(edep, chunk.columnBytes[EdMedPhColumnar::kEdep]);
+    WriteColumn(x, chunk.columnBytes[EdMedPhColumnar::kX]);
+    WriteColumn(y, chunk.columnBytes[EdMedPhColumnar::kY]);
+    WriteColumn(z, chunk.columnBytes[EdMedPhColumnar::kZ]);
+    WriteColumn(eventID, chunk.columnBytes[EdMedPhColumnar::kEventID]);
+  }
+  else {
+    for ( G4int i = 0; i < EdMedPhColumnar::kNofColumns; ++i ) {
+      chunk.columnBytes[i] = fColumns[i].size();
+    }
+    fFile.write(reinterpret_cast<const char*>(&chunk), sizeof(chunk));
+    for ( const auto& column : fColumns ) {
+      WriteColumn(column.data(), column.size());
+    }
+  }
+
+  fNofRows += nofRows;
+  ++fNofChunks;
+  fRawBytes += nofRows*EdMedPhColumnar::kNofColumns
+              *EdMedPhColumnar::kBytesPerValue;
+  fWrittenBytes += EdMedPhColumnar::ChunkSize(chunk);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhColumnarWriter::WriteColumn(const void* data, std::size_t size)
+{
+  fFile.write(static_cast<const char*>(data), size);
+  fFile.write(kPadding, EdMedPhColumnar::PaddedSize(size) - size);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool EdMedPhColumnarWriter::MergeFiles(
+                                  const G4String& fileName,
+                                  const std::vector<G4String>& partFileNames)
+{
+  std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+  if ( ! file ) {
+    G4ExceptionDescription msg;
+    msg << "Cannot open columnar hit file " << fileName; 
+    G4Exception("EdMedPhColumnarWriter::MergeFiles()",
+      "MyCode0015", JustWarning, msg);
+    return false;
+  }
+
+  auto header = MakeHeader();
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+  // append the chunks of each part, skipping its header
+  std::vector<char> block(1 << 20);
+  for ( const auto& partFileName : partFileNames ) {
+    std::ifstream part(partFileName, std::ios::binary);
+    EdMedPhColumnarHeader partHeader;
+    if ( ! part.read(reinterpret_cast<char*>(&partHeader), 
+                     sizeof(partHeader)) ) continue;
+    if ( std::memcmp(partHeader.magic, kMagic, sizeof(kMagic)) != 0 ) {
+      G4ExceptionDescription msg;
+      msg << partFileName << " is not a columnar hit file, skipped";
+      G4Exception("EdMedPhColumnarWriter::MergeFiles()",
+        "MyCode0015", JustWarning, msg);
+      continue;
+    }
+    header.nofRows += partHeader.nofRows;
+    header.nofChunks += partHeader.nofChunks;
+    while ( part.read(block.data(), block.size()) || part.gcount() > 0 ) {
+      file.write(block.data(), part.gcount());
+    }
+    part.close();
+    std::remove(partFileName.c_str());
+  }
+
+  file.seekp(0);
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
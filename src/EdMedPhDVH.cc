@@ -0,0 +1,86 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhDVH.cc
+/// \brief Implementation of the EdMedPhDVH class
+
+#include "EdMedPhDVH.hh"
+
+#include <algorithm>
+#include <functional>
+#include <numeric>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhDVH::EdMedPhDVH(const G4String& name)
+ : fName(name)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhDVH::~EdMedPhDVH()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhDVH::Finish()
+{
+  std::sort(fDoses.begin(), fDoses.end(), std::greater<G4double>());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double EdMedPhDVH::GetVolumeFraction(G4double dose) const
+{
+  if ( fDoses.empty() ) return 0.;
+
+  // number of voxels with at least this dose
+  auto end = std::upper_bound(fDoses.begin(), fDoses.end(), dose, 
+                              std::greater<G4double>());
+  return G4double(end - fDoses.begin())/fDoses.size();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double EdMedPhDVH::GetDose(G4double volumeFraction) const
+{
+  if ( fDoses.empty() ) return 0.;
+
+  auto n = G4int(volumeFraction*fDoses.size() + 0.5);
+  n = std::min(std::max(n, 1), G4int(fDoses.size()));
+  return fDoses[n - 1];
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double EdMedPhDVH::GetMeanDose() const
+{
+  if ( fDoses.empty() ) return 0.;
+
+  return std::accumulate(fDoses.begin(), fDoses.end(), 0.)/fDoses.size();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
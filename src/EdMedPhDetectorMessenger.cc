@@ -0,0 +1,196 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhDetectorMessenger.cc
+/// \brief Implementation of the EdMedPhDetectorMessenger class
+
+#include "EdMedPhDetectorMessenger.hh"
+#include "EdMedPhcDetectorConstruction.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithABool.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhDetectorMessenger::EdMedPhDetectorMessenger(
+                            EdMedPhcDetectorConstruction* detector)
+ : G4UImessenger(),
+   fDetector(detector)
+{
+  fDetDirectory = new G4UIdirectory("/EdMedPh/det/", false);
+  fDetDirectory->SetGuidance("Detector geometry control.");
+  fDetDirectory->SetGuidance("Size and mode changes rebuild the geometry");
+  fDetDirectory->SetGuidance("at the next run, material changes only the");
+  fDetDirectory->SetGuidance("physics tables.");
+
+  fGeometryCmd = new G4UIcmdWithAString("/EdMedPh/det/geometry", this);
+  fGeometryCmd->SetGuidance("Select the phantom geometry:");
+  fGeometryCmd->SetGuidance("  layered: replicated absorber and gap layers,");
+  fGeometryCmd->SetGuidance("  solid: one absorber volume, the layers are only");
+  fGeometryCmd->SetGuidance("         a scoring binning along z,");
+  fGeometryCmd->SetGuidance("  ct: voxelised phantom of /EdMedPh/det/ctFile.");
+  fGeometryCmd->SetParameterName("mode", false);
+  fGeometryCmd->SetCandidates("layered solid ct");
+  fGeometryCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fNofLayersCmd = new G4UIcmdWithAnInteger("/EdMedPh/det/nofLayers", this);
+  fNofLayersCmd->SetGuidance("Set the number of layers (scoring cells).");
+  fNofLayersCmd->SetParameterName("n", false);
+  fNofLayersCmd->SetRange("n>0");
+  fNofLayersCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fAbsoThicknessCmd 
+    = new G4UIcmdWithADoubleAndUnit("/EdMedPh/det/absoThickness", this);
+  fAbsoThicknessCmd->SetGuidance("Set the absorber thickness of a layer.");
+  fAbsoThicknessCmd->SetParameterName("thickness", false);
+  fAbsoThicknessCmd->SetRange("thickness>0.");
+  fAbsoThicknessCmd->SetUnitCategory("Length");
+  fAbsoThicknessCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fGapThicknessCmd 
+    = new G4UIcmdWithADoubleAndUnit("/EdMedPh/det/gapThickness", this);
+  fGapThicknessCmd->SetGuidance("Set the gap thickness of a layer.");
+  fGapThicknessCmd->SetParameterName("thickness", false);
+  fGapThicknessCmd->SetRange("thickness>0.");
+  fGapThicknessCmd->SetUnitCategory("Length");
+  fGapThicknessCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fSizeXYCmd = new G4UIcmdWithADoubleAndUnit("/EdMedPh/det/sizeXY", this);
+  fSizeXYCmd->SetGuidance("Set the transverse size of the calorimeter.");
+  fSizeXYCmd->SetParameterName("size", false);
+  fSizeXYCmd->SetRange("size>0.");
+  fSizeXYCmd->SetUnitCategory("Length");
+  fSizeXYCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fAbsoMaterialCmd 
+    = new G4UIcmdWithAString("/EdMedPh/det/absoMaterial", this);
+  fAbsoMaterialCmd->SetGuidance("Set the absorber material (NIST name).");
+  fAbsoMaterialCmd->SetParameterName("material", false);
+  fAbsoMaterialCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fGapMaterialCmd = new G4UIcmdWithAString("/EdMedPh/det/gapMaterial", this);
+  fGapMaterialCmd->SetGuidance("Set the gap material (NIST name).");
+  fGapMaterialCmd->SetParameterName("material", false);
+  fGapMaterialCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fCTFileCmd = new G4UIcmdWithAString("/EdMedPh/det/ctFile", this);
+  fCTFileCmd->SetGuidance("Set the CT phantom file of the ct geometry");
+  fCTFileCmd->SetGuidance("(layout in EdMedPhCTFormat.hh).");
+  fCTFileCmd->SetParameterName("fileName", false);
+  fCTFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fRegularNavigationCmd 
+    = new G4UIcmdWithABool("/EdMedPh/det/regularNavigation", this);
+  fRegularNavigationCmd->SetGuidance("Use the regular structure navigation in");
+  fRegularNavigationCmd->SetGuidance("the CT phantom, skipping the boundaries");
+  fRegularNavigationCmd->SetGuidance("between voxels of equal material.");
+  fRegularNavigationCmd->SetParameterName("flag", false);
+  fRegularNavigationCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fGapSDCmd = new G4UIcmdWithABool("/EdMedPh/det/gapSD", this);
+  fGapSDCmd->SetGuidance("Also score the gaps of the layered geometry.");
+  fGapSDCmd->SetParameterName("flag", false);
+  fGapSDCmd->AvailableForStates(G4State_PreInit);
+
+  fExportHitsCmd = new G4UIcmdWithABool("/EdMedPh/det/exportHits", this);
+  fExportHitsCmd->SetGuidance("Copy the per-layer sums to hits collections");
+  fExportHitsCmd->SetGuidance("at the end of each event.");
+  fExportHitsCmd->SetParameterName("flag", false);
+  fExportHitsCmd->AvailableForStates(G4State_PreInit);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhDetectorMessenger::~EdMedPhDetectorMessenger()
+{
+  delete fGeometryCmd;
+  delete fNofLayersCmd;
+  delete fAbsoThicknessCmd;
+  delete fGapThicknessCmd;
+  delete fSizeXYCmd;
+  delete fAbsoMaterialCmd;
+  delete fGapMaterialCmd;
+  delete fCTFileCmd;
+  delete fRegularNavigationCmd;
+  delete fGapSDCmd;
+  delete fExportHitsCmd;
+  delete fDetDirectory;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhDetectorMessenger::SetNewValue(G4UIcommand* command, 
+                                           G4String newValue)
+{
+  if ( command == fGeometryCmd ) {
+    if ( newValue == "solid" ) {
+      fDetector->SetGeometryMode(EdMedPhcDetectorConstruction::kSolid);
+    }
+    else if ( newValue == "ct" ) {
+      fDetector->SetGeometryMode(EdMedPhcDetectorConstruction::kCT);
+    }
+    else {
+      fDetector->SetGeometryMode(EdMedPhcDetectorConstruction::kLayered);
+    }
+  }
+  else if ( command == fNofLayersCmd ) {
+    fDetector->SetNofLayers(fNofLayersCmd->GetNewIntValue(newValue));
+  }
+  else if ( command == fAbsoThicknessCmd ) {
+    fDetector->SetAbsoThickness(
+      fAbsoThicknessCmd->GetNewDoubleValue(newValue));
+  }
+  else if ( command == fGapThicknessCmd ) {
+    fDetector->SetGapThickness(fGapThicknessCmd->GetNewDoubleValue(newValue));
+  }
+  else if ( command == fSizeXYCmd ) {
+    fDetector->SetCalorSizeXY(fSizeXYCmd->GetNewDoubleValue(newValue));
+  }
+  else if ( command == fAbsoMaterialCmd ) {
+    fDetector->SetAbsorberMaterial(newValue);
+  }
+  else if ( command == fGapMaterialCmd ) {
+    fDetector->SetGapMaterial(newValue);
+  }
+  else if ( command == fCTFileCmd ) {
+    fDetector->SetCTFile(newValue);
+  }
+  else if ( command == fRegularNavigationCmd ) {
+    fDetector->SetRegularNavigation(
+      fRegularNavigationCmd->GetNewBoolValue(newValue));
+  }
+  else if ( command == fGapSDCmd ) {
+    fDetector->SetGapSD(fGapSDCmd->GetNewBoolValue(newValue));
+  }
+  else if ( command == fExportHitsCmd ) {
+    fDetector->SetExportHits(fExportHitsCmd->GetNewBoolValue(newValue));
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
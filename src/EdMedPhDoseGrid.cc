@@ -0,0 +1,165 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhDoseGrid.cc
+/// \brief Implementation of the EdMedPhDoseGrid class
+
+#include "EdMedPhDoseGrid.hh"
+
+#include "G4SystemOfUnits.hh"
+
+#include <algorithm>
+#include <cstdint>
+#include <fstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhDoseGrid::EdMedPhDoseGrid()
+ : fNx(0), fNy(0), fNz(0),
+   fInvDx(0.), fInvDy(0.), fInvDz(0.)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhDoseGrid::~EdMedPhDoseGrid()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhDoseGrid::SetBinning(G4int nx, G4int ny, G4int nz,
+                                 const G4ThreeVector& lower, 
+                                 const G4ThreeVector& upper)
+{
+  if ( nx <= 0 || ny <= 0 || nz <= 0 ||
+       upper.x() <= lower.x() || upper.y() <= lower.y() || 
+       upper.z() <= lower.z() ) {
+    G4ExceptionDescription msg;
+    msg << "Invalid dose grid binning " 
+        << nx << " x " << ny << " x " << nz 
+        << " over " << lower << " - " << upper;
+    G4Exception("EdMedPhDoseGrid::SetBinning()",
+      "MyCode0005", FatalException, msg);
+    return;
+  }
+
+  fNx = nx;
+  fNy = ny;
+  fNz = nz;
+  fLower = lower;
+  fUpper = upper;
+  fInvDx = nx/(upper.x() - lower.x());
+  fInvDy = ny/(upper.y() - lower.y());
+  fInvDz = nz/(upper.z() - lower.z());
+  fEdep.assign(nx*ny*nz, 0.);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhDoseGrid::Reset()
+{
+  std::fill(fEdep.begin(), fEdep.end(), 0.);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhDoseGrid::Merge(const EdMedPhDoseGrid& other)
+{
+  if ( ! other.IsEnabled() ) return;
+
+  if ( other.fEdep.size() != fEdep.size() ) {
+    G4ExceptionDescription msg;
+    msg << "Cannot merge dose grids of different binning."; 
+    G4Exception("EdMedPhDoseGrid::Merge()",
+      "MyCode0006", FatalException, msg);
+    return;
+  }
+
+  for ( std::size_t i=0; i<fEdep.size(); i++ ) {
+    fEdep[i] += other.fEdep[i];
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double EdMedPhDoseGrid::GetVoxelVolume() const
+{
+  if ( ! IsEnabled() ) return 0.;
+  return 1./(fInvDx*fInvDy*fInvDz);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double EdMedPhDoseGrid::GetTotalEdep() const
+{
+  G4double sum = 0.;
+  for ( auto edep : fEdep ) sum += edep;
+  return sum;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4ThreeVector EdMedPhDoseGrid::GetVoxelCentre(G4int i) const
+{
+  G4int ix = i % fNx;
+  G4int iy = (i / fNx) % fNy;
+  G4int iz = i / (fNx*fNy);
+
+  return G4ThreeVector(fLower.x() + (ix + 0.5)/fInvDx,
+                       fLower.y() + (iy + 0.5)/fInvDy,
+                       fLower.z() + (iz + 0.5)/fInvDz);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhDoseGrid::Write(const G4String& fileName) const
+{
+  // File layout (little endian, see root_macros/read_dose_map.C):
+  //   char[8]   "EDMPDOSE"
+  //   int32 x3  nx, ny, nz
+  //   double x6 lower and upper grid corners (mm)
+  //   double    energy deposit per voxel (MeV), x index fastest
+  //
+  std::ofstream file(fileName, std::ios::binary);
+  if ( ! file ) {
+    G4ExceptionDescription msg;
+    msg << "Cannot open dose map file " << fileName; 
+    G4Exception("EdMedPhDoseGrid::Write()",
+      "MyCode0007", JustWarning, msg);
+    return;
+  }
+
+  const char magic[8] = { 'E', 'D', 'M', 'P', 'D', 'O', 'S', 'E' };
+  std::int32_t dims[3] = { fNx, fNy, fNz };
+  G4double corners[6] = { fLower.x()/mm, fLower.y()/mm, fLower.z()/mm,
+                          fUpper.x()/mm, fUpper.y()/mm, fUpper.z()/mm };
+  file.write(magic, sizeof(magic));
+  file.write(reinterpret_cast<const char*>(dims), sizeof(dims));
+  file.write(reinterpret_cast<const char*>(corners), sizeof(corners));
+  file.write(reinterpret_cast<const char*>(fEdep.data()), 
+             fEdep.size()*sizeof(G4double));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,106 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhHitBuffer.cc
+/// \brief Implementation of the EdMedPhHitBuffer class
+
+#include "EdMedPhHitBuffer.hh"
+#include "EdMedPhColumnarWriter.hh"
+#include "EdMedPhAnalysis.hh"
+
+#include "G4Timer.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhHitBuffer::EdMedPhHitBuffer()
+ : fNtupleId(0),
+   fColumnarWriter(nullptr),
+   fCapacity(0),
+   fSize(0),
+   fNofRows(0.),
+   fFlushTime(0.)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhHitBuffer::~EdMedPhHitBuffer()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhHitBuffer::SetCapacity(G4int capacity)
+{
+  // Never drop buffered rows when resizing
+  Flush();
+
+  fCapacity = capacity > 0 ? capacity : 0;
+  fEdep.resize(fCapacity);
+  fX.resize(fCapacity);
+  fY.resize(fCapacity);
+  fZ.resize(fCapacity);
+  fEventID.resize(fCapacity);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhHitBuffer::Flush()
+{
+  if ( fSize == 0 ) return;
+
+  G4Timer timer;
+  timer.Start();
+
+  if ( fColumnarWriter ) {
+    fColumnarWriter->WriteChunk(fSize, fEdep.data(), fX.data(), fY.data(),
+                                fZ.data(), fEventID.data());
+  }
+  else {
+    auto analysisManager = G4AnalysisManager::Instance();
+    for ( G4int i=0; i<fSize; i++ ) {
+      analysisManager->FillNtupleFColumn(fNtupleId, 0, fEdep[i]);
+      analysisManager->FillNtupleFColumn(fNtupleId, 1, fX[i]);
+      analysisManager->FillNtupleFColumn(fNtupleId, 2, fY[i]);
+      analysisManager->FillNtupleFColumn(fNtupleId, 3, fZ[i]);
+      analysisManager->FillNtupleIColumn(fNtupleId, 4, fEventID[i]);
+      analysisManager->AddNtupleRow(fNtupleId);
+    }
+  }
+
+  timer.Stop();
+  fFlushTime += timer.GetRealElapsed();
+  fNofRows += fSize;
+  fSize = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhHitBuffer::ResetStatistics()
+{
+  fNofRows = 0.;
+  fFlushTime = 0.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,153 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhPhaseSpaceReader.cc
+/// \brief Implementation of the EdMedPhPhaseSpaceReader class
+
+#include "EdMedPhPhaseSpaceReader.hh"
+
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhPhaseSpaceReader::EdMedPhPhaseSpaceReader()
+ : fMapping(nullptr),
+   fMappingSize(0),
+   fRecords(nullptr),
+   fGroups(nullptr),
+   fNofGroups(0)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhPhaseSpaceReader::~EdMedPhPhaseSpaceReader()
+{
+  Close();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool EdMedPhPhaseSpaceReader::Open(const G4String& fileName)
+{
+  Close();
+
+  G4ExceptionDescription msg;
+  auto fd = open(fileName.c_str(), O_RDONLY);
+  struct stat status;
+  if ( fd < 0 || fstat(fd, &status) != 0 ) {
+    msg << "Cannot open phase-space file " << fileName; 
+  }
+  else if ( static_cast<std::size_t>(status.st_size) 
+              < sizeof(EdMedPhPhaseSpaceHeader) ) {
+    msg << "Phase-space file " << fileName << " is truncated"; 
+  }
+  else {
+    fMappingSize = status.st_size;
+    fMapping = mmap(nullptr, fMappingSize, PROT_READ, MAP_SHARED, fd, 0);
+    if ( fMapping == MAP_FAILED ) {
+      fMapping = nullptr;
+      msg << "Cannot map phase-space file " << fileName; 
+    }
+  }
+  if ( fd >= 0 ) close(fd);
+
+  // check the header against the file size, the rest is the index
+  std::uint64_t nofRecords = 0;
+  std::size_t indexSize = 0;
+  if ( fMapping ) {
+    auto header = static_cast<const EdMedPhPhaseSpaceHeader*>(fMapping);
+    nofRecords = header->nofRecords;
+    auto recordsEnd = sizeof(EdMedPhPhaseSpaceHeader) 
+                    + nofRecords*sizeof(EdMedPhPhaseSpaceRecord);
+    if ( std::memcmp(header->magic, "EDMPPHSP", 8) != 0 ) {
+      msg << fileName << " is not a phase-space file";
+    }
+    else if ( nofRecords == 0 || recordsEnd > fMappingSize 
+              || (fMappingSize - recordsEnd) 
+                   % sizeof(EdMedPhPhaseSpaceGroup) != 0 ) {
+      msg << "Phase-space file " << fileName << " has " << nofRecords 
+          << " records but " << fMappingSize << " bytes";
+    }
+    else if ( recordsEnd == fMappingSize ) {
+      msg << "Phase-space file " << fileName << " has no event index";
+    }
+    else {
+      indexSize = fMappingSize - recordsEnd;
+    }
+  }
+
+  if ( ! msg.str().empty() ) {
+    Close();
+    G4Exception("EdMedPhPhaseSpaceReader::Open()",
+      "MyCode0009", JustWarning, msg);
+    return false;
+  }
+
+  fFileName = fileName;
+  fRecords = reinterpret_cast<const EdMedPhPhaseSpaceRecord*>(
+    static_cast<const char*>(fMapping) + sizeof(EdMedPhPhaseSpaceHeader));
+  madvise(fMapping, fMappingSize, MADV_SEQUENTIAL);
+
+  fGroups = reinterpret_cast<const EdMedPhPhaseSpaceGroup*>(
+    fRecords + nofRecords);
+  fNofGroups = indexSize/sizeof(EdMedPhPhaseSpaceGroup);
+  for ( std::size_t i = 0; i < fNofGroups; ++i ) {
+    if ( fGroups[i].firstRecord + fGroups[i].nofRecords > nofRecords ) {
+      G4ExceptionDescription badIndex;
+      badIndex << "Phase-space file " << fileName 
+               << " has an index beyond its records";
+      Close();
+      G4Exception("EdMedPhPhaseSpaceReader::Open()",
+        "MyCode0009", JustWarning, badIndex);
+      return false;
+    }
+  }
+
+  G4cout << " Phase space " << fileName << " : " << nofRecords 
+         << " particles in " << GetNofEvents() << " events" << G4endl;
+
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhPhaseSpaceReader::Close()
+{
+  if ( fMapping ) munmap(fMapping, fMappingSize);
+  fMapping = nullptr;
+  fMappingSize = 0;
+  fRecords = nullptr;
+  fGroups = nullptr;
+  fNofGroups = 0;
+  fFileName = "";
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
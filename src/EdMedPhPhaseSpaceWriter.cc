@@ -0,0 +1,200 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhPhaseSpaceWriter.cc
+/// \brief Implementation of the EdMedPhPhaseSpaceWriter class
+
+#include "EdMedPhPhaseSpaceWriter.hh"
+
+#include "G4SystemOfUnits.hh"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+  const char kMagic[8] = { 'E', 'D', 'M', 'P', 'P', 'H', 'S', 'P' };
+  const std::size_t kBufferSize = 4096;
+
+  void WriteIndex(std::ofstream& file, 
+                  std::vector<EdMedPhPhaseSpaceGroup>& groups)
+  {
+    std::stable_sort(groups.begin(), groups.end(),
+      [](const EdMedPhPhaseSpaceGroup& a, const EdMedPhPhaseSpaceGroup& b)
+        { return a.eventID < b.eventID; });
+    file.write(reinterpret_cast<const char*>(groups.data()),
+               groups.size()*sizeof(EdMedPhPhaseSpaceGroup));
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhPhaseSpaceWriter::EdMedPhPhaseSpaceWriter()
+ : fNofRecords(0)
+{
+  fBuffer.reserve(kBufferSize);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhPhaseSpaceWriter::~EdMedPhPhaseSpaceWriter()
+{
+  Close();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool EdMedPhPhaseSpaceWriter::Open(const G4String& fileName)
+{
+  Close();
+
+  fFile.open(fileName, std::ios::binary | std::ios::trunc);
+  if ( ! fFile ) {
+    G4ExceptionDescription msg;
+    msg << "Cannot open phase-space file " << fileName; 
+    G4Exception("EdMedPhPhaseSpaceWriter::Open()",
+      "MyCode0009", JustWarning, msg);
+    return false;
+  }
+
+  // header, the record count is patched in Close()
+  EdMedPhPhaseSpaceHeader header;
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.nofRecords = 0;
+  fFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  fNofRecords = 0;
+  fGroups.clear();
+
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhPhaseSpaceWriter::Close()
+{
+  if ( ! fFile.is_open() ) return;
+
+  Flush();
+  WriteIndex(fFile, fGroups);
+  fFile.seekp(offsetof(EdMedPhPhaseSpaceHeader, nofRecords));
+  fFile.write(reinterpret_cast<const char*>(&fNofRecords), 
+              sizeof(fNofRecords));
+  fFile.close();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhPhaseSpaceWriter::Record(G4int eventID, G4int pdgCode, 
+                                     G4double energy,
+                                     const G4ThreeVector& position,
+                                     const G4ThreeVector& direction)
+{
+  EdMedPhPhaseSpaceRecord record;
+  record.eventID = eventID;
+  record.pdgCode = pdgCode;
+  record.energy = energy/MeV;
+  record.x = position.x()/mm;
+  record.y = position.y()/mm;
+  record.z = position.z()/mm;
+  record.dx = direction.x();
+  record.dy = direction.y();
+  record.dz = direction.z();
+  fBuffer.push_back(record);
+
+  if ( fGroups.empty() || fGroups.back().eventID != eventID ) {
+    fGroups.push_back({ eventID, 0, fNofRecords + fBuffer.size() - 1 });
+  }
+  ++fGroups.back().nofRecords;
+
+  if ( fBuffer.size() == kBufferSize ) Flush();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhPhaseSpaceWriter::Flush()
+{
+  if ( fBuffer.empty() ) return;
+
+  fFile.write(reinterpret_cast<const char*>(fBuffer.data()),
+              fBuffer.size()*sizeof(EdMedPhPhaseSpaceRecord));
+  fNofRecords += fBuffer.size();
+  fBuffer.clear();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool EdMedPhPhaseSpaceWriter::MergeFiles(
+                                  const G4String& fileName,
+                                  const std::vector<G4String>& partFileNames)
+{
+  std::ofstream file(fileName, std::ios::binary | std::ios::trunc);
+  if ( ! file ) {
+    G4ExceptionDescription msg;
+    msg << "Cannot open phase-space file " << fileName; 
+    G4Exception("EdMedPhPhaseSpaceWriter::MergeFiles()",
+      "MyCode0009", JustWarning, msg);
+    return false;
+  }
+
+  EdMedPhPhaseSpaceHeader header;
+  std::memcpy(header.magic, kMagic, sizeof(kMagic));
+  header.nofRecords = 0;
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+  // append the records of each part, skipping its header, and collect
+  // its index with the record positions shifted by the preceding parts
+  std::vector<char> block(1 << 20);
+  std::vector<EdMedPhPhaseSpaceGroup> groups;
+  for ( const auto& partFileName : partFileNames ) {
+    std::ifstream part(partFileName, std::ios::binary);
+    EdMedPhPhaseSpaceHeader partHeader;
+    if ( ! part.read(reinterpret_cast<char*>(&partHeader), 
+                     sizeof(partHeader)) ) continue;
+    auto bytes = partHeader.nofRecords*sizeof(EdMedPhPhaseSpaceRecord);
+    while ( bytes > 0 ) {
+      auto size = std::min<std::uint64_t>(bytes, block.size());
+      if ( ! part.read(block.data(), size) ) break;
+      file.write(block.data(), size);
+      bytes -= size;
+    }
+    EdMedPhPhaseSpaceGroup group;
+    while ( part.read(reinterpret_cast<char*>(&group), sizeof(group)) ) {
+      group.firstRecord += header.nofRecords;
+      groups.push_back(group);
+    }
+    header.nofRecords += partHeader.nofRecords;
+    part.close();
+    std::remove(partFileName.c_str());
+  }
+  WriteIndex(file, groups);
+
+  file.seekp(offsetof(EdMedPhPhaseSpaceHeader, nofRecords));
+  file.write(reinterpret_cast<const char*>(&header.nofRecords), 
+             sizeof(header.nofRecords));
+  return true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
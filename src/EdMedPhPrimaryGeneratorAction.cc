@@ -29,23 +29,42 @@
 /// \brief Implementation of the EdMedPhPrimaryGeneratorAction class
 
 #include "EdMedPhPrimaryGeneratorAction.hh"
+#include "EdMedPhPrimaryGeneratorMessenger.hh"
+#include "EdMedPhPhaseSpaceWriter.hh"
+#include "EdMedPhEventSeeds.hh"
 
 #include "G4RunManager.hh"
+#include "G4Run.hh"
 #include "G4LogicalVolumeStore.hh"
 #include "G4LogicalVolume.hh"
 #include "G4Box.hh"
 #include "G4Event.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4PrimaryParticle.hh"
 #include "G4ParticleGun.hh"
 #include "G4ParticleTable.hh"
+#include "G4IonTable.hh"
 #include "G4ParticleDefinition.hh"
 #include "G4SystemOfUnits.hh"
 #include "Randomize.hh"
 
+#include <algorithm>
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 EdMedPhPrimaryGeneratorAction::EdMedPhPrimaryGeneratorAction()
  : G4VUserPrimaryGeneratorAction(),
-   fParticleGun(nullptr)
+   fParticleGun(nullptr),
+   fMessenger(nullptr),
+   fWorldZHalfLength(0.),
+   fBatch(1024),
+   fNext(fBatch.size()),
+   fBatchSizeSet(false),
+   fPhaseSpaceWriter(nullptr),
+   fEventSeeds(true),
+   fRunSeed(12345),
+   fFirstEvent(0),
+   fSeedRunID(-1)
 {
   G4int nofParticles = 1;
   fParticleGun = new G4ParticleGun(nofParticles);
@@ -57,26 +76,83 @@ EdMedPhPrimaryGeneratorAction::EdMedPhPrimaryGeneratorAction()
   fParticleGun->SetParticleDefinition(particleDefinition);
   fParticleGun->SetParticleMomentumDirection(G4ThreeVector(0.,0.,1.));
   fParticleGun->SetParticleEnergy(50.*MeV);
+
+  fMessenger = new EdMedPhPrimaryGeneratorMessenger(this);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 EdMedPhPrimaryGeneratorAction::~EdMedPhPrimaryGeneratorAction()
 {
+  delete fMessenger;
   delete fParticleGun;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void EdMedPhPrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
+void EdMedPhPrimaryGeneratorAction::SetBatchSize(G4int value)
 {
-  // This function is called at the begining of event
+  fBatch.resize(value);
+  fNext = fBatch.size();
+  fBatchSizeSet = true;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhPrimaryGeneratorAction::SetPhaseSpaceFile(const G4String& fileName)
+{
+  fPhaseSpaceFileName = ( fileName == "none" ) ? G4String() : fileName;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhPrimaryGeneratorAction::SetPhaseSpaceWriter(
+                                      EdMedPhPhaseSpaceWriter* writer)
+{
+  fPhaseSpaceWriter = writer;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhPrimaryGeneratorAction::SetEventSeeds(G4bool value)
+{
+  fEventSeeds = value;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhPrimaryGeneratorAction::SetRunSeed(G4long value)
+{
+  fRunSeed = value;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhPrimaryGeneratorAction::SetReplayEvent(G4int eventID, G4int runID)
+{
+  fFirstEvent = std::max(eventID, 0);
+  fSeedRunID = ( eventID >= 0 ) ? runID : -1;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhPrimaryGeneratorAction::SetFirstEvent(G4int eventID)
+{
+  fFirstEvent = eventID;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhPrimaryGeneratorAction::BeginOfRun()
+{
+  // This function is called at the begining of run,
+  // the geometry may have changed since the previous one
 
   // In order to avoid dependence of PrimaryGeneratorAction
   // on DetectorConstruction class we get world volume 
   // from G4LogicalVolumeStore
   //
-  G4double worldZHalfLength = 0.;
+  fWorldZHalfLength = 0.;
   auto worldLV = G4LogicalVolumeStore::GetInstance()->GetVolume("World");
 
   // Check that the world volume has box shape
@@ -86,23 +162,188 @@ void EdMedPhPrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
   }
 
   if ( worldBox ) {
-    worldZHalfLength = worldBox->GetZHalfLength();  
+    fWorldZHalfLength = worldBox->GetZHalfLength();  
   }
   else  {
     G4ExceptionDescription msg;
     msg << "World volume of box shape not found." << G4endl;
     msg << "Perhaps you have changed geometry." << G4endl;
     msg << "The gun will be place in the center.";
-    G4Exception("EdMedPhPrimaryGeneratorAction::GeneratePrimaries()",
+    G4Exception("EdMedPhPrimaryGeneratorAction::BeginOfRun()",
       "MyCode0002", JustWarning, msg);
   } 
-  
-  // Set gun position
-  fParticleGun
-    ->SetParticlePosition(G4ThreeVector(0., 0., -worldZHalfLength));
 
-  fParticleGun->GeneratePrimaryVertex(anEvent);
+  // Prepare the beam sampling tables and discard primaries 
+  // sampled with the previous run settings
+  fBeamModel.BuildTables();
+  fNext = fBatch.size();
+
+  // Map the phase-space file to replay, if any
+  if ( fPhaseSpaceFileName.empty() ) {
+    fPhaseSpace.Close();
+  }
+  else if ( fPhaseSpace.GetFileName() != fPhaseSpaceFileName ) {
+    if ( ! fPhaseSpace.Open(fPhaseSpaceFileName) ) {
+      G4ExceptionDescription msg;
+      msg << "Cannot replay phase space " << fPhaseSpaceFileName;
+      G4Exception("EdMedPhPrimaryGeneratorAction::BeginOfRun()",
+        "MyCode0010", FatalException, msg);
+    }
+  }
+
+  if ( fSeedRunID >= 0 && ! fEventSeeds ) {
+    G4ExceptionDescription msg;
+    msg << "Replaying event " << fFirstEvent 
+        << " without /EdMedPh/random/eventSeeds," << G4endl;
+    msg << "it will not reproduce the original event.";
+    G4Exception("EdMedPhPrimaryGeneratorAction::BeginOfRun()",
+      "MyCode0016", JustWarning, msg);
+  }
+
+  if ( fBatchSizeSet && fEventSeeds && ! fPhaseSpace.IsOpen() ) {
+    G4ExceptionDescription msg;
+    msg << "/EdMedPh/beam/batchSize has no effect with "
+        << "/EdMedPh/random/eventSeeds true:" << G4endl;
+    msg << "each primary is sampled from its own event's seeds.";
+    G4Exception("EdMedPhPrimaryGeneratorAction::BeginOfRun()",
+      "MyCode0019", JustWarning, msg);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhPrimaryGeneratorAction::SamplePrimary(
+                                      CLHEP::HepRandomEngine* engine,
+                                      Primary& primary) const
+{
+  fBeamModel.Sample(engine, 
+                    fParticleGun->GetParticleEnergy(), 
+                    fParticleGun->GetParticleMomentumDirection(),
+                    primary.position, primary.direction, primary.energy);
+  primary.position += G4ThreeVector(0., 0., -fWorldZHalfLength);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+void EdMedPhPrimaryGeneratorAction::FillBatch()
+{
+  auto engine = G4Random::getTheEngine();
+
+  for ( auto& primary : fBatch ) {
+    SamplePrimary(engine, primary);
+  }
+  fNext = 0;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhPrimaryGeneratorAction::SeedEvent(G4Event* anEvent)
+{
+  auto runID = G4RunManager::GetRunManager()->GetCurrentRun()->GetRunID();
+
+  // renumber the event as in the replayed run or the whole split job, 
+  // so that the outputs (hits, phase space) carry the original event ID
+  if ( fFirstEvent > 0 ) {
+    anEvent->SetEventID(fFirstEvent + anEvent->GetEventID());
+  }
+  if ( fSeedRunID >= 0 ) {
+    runID = fSeedRunID;
+    G4cout << "--> Replaying event " << anEvent->GetEventID() 
+           << " of run " << runID << G4endl;
+  }
+
+  if ( fEventSeeds ) {
+    long seeds[3];
+    EdMedPhRandom::GetEventSeeds(
+      fRunSeed, runID, anEvent->GetEventID(), seeds);
+    G4Random::setTheSeeds(seeds, -1);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4ParticleDefinition* 
+EdMedPhPrimaryGeneratorAction::FindParticle(G4int pdgCode) const
+{
+  auto particleDefinition 
+    = G4ParticleTable::GetParticleTable()->FindParticle(pdgCode);
+  if ( ! particleDefinition ) {
+    // nuclei are created on demand
+    particleDefinition = G4IonTable::GetIonTable()->GetIon(pdgCode);
+  }
+  if ( ! particleDefinition ) {
+    G4ExceptionDescription msg;
+    msg << "Unknown PDG code " << pdgCode << " in phase space " 
+        << fPhaseSpace.GetFileName();
+    G4Exception("EdMedPhPrimaryGeneratorAction::FindParticle()",
+      "MyCode0010", FatalException, msg);
+  }
+  return particleDefinition;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhPrimaryGeneratorAction::ReplayPhaseSpace(G4Event* anEvent)
+{
+  auto eventID = anEvent->GetEventID();
+  auto end = fPhaseSpace.End(eventID);
+
+  for ( auto record = fPhaseSpace.Begin(eventID); record != end; ++record ) {
+    G4ThreeVector position(record->x*mm, record->y*mm, record->z*mm);
+    G4ThreeVector direction(record->dx, record->dy, record->dz);
+
+    auto particle = new G4PrimaryParticle(FindParticle(record->pdgCode));
+    particle->SetKineticEnergy(record->energy*MeV);
+    particle->SetMomentumDirection(direction);
+
+    auto vertex = new G4PrimaryVertex(position, 0.);
+    vertex->SetPrimary(particle);
+    anEvent->AddPrimaryVertex(vertex);
+
+    if ( fPhaseSpaceWriter ) {
+      fPhaseSpaceWriter->Record(eventID, record->pdgCode, 
+                                record->energy*MeV, position, direction);
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhPrimaryGeneratorAction::GeneratePrimaries(G4Event* anEvent)
+{
+  // This function is called at the begining of event
+
+  SeedEvent(anEvent);
+
+  if ( fPhaseSpace.IsOpen() ) {
+    ReplayPhaseSpace(anEvent);
+    return;
+  }
+
+  // with per-event seeds, the primary must come from this event's seeds
+  Primary primary;
+  if ( fEventSeeds ) {
+    SamplePrimary(G4Random::getTheEngine(), primary);
+  }
+  else {
+    if ( fNext == fBatch.size() ) FillBatch();
+    primary = fBatch[fNext++];
+  }
+
+  auto particle 
+    = new G4PrimaryParticle(fParticleGun->GetParticleDefinition());
+  particle->SetKineticEnergy(primary.energy);
+  particle->SetMomentumDirection(primary.direction);
+
+  auto vertex = new G4PrimaryVertex(primary.position, 0.);
+  vertex->SetPrimary(particle);
+  anEvent->AddPrimaryVertex(vertex);
+
+  if ( fPhaseSpaceWriter ) {
+    fPhaseSpaceWriter->Record(
+      anEvent->GetEventID(), particle->GetPDGcode(), 
+      primary.energy, primary.position, primary.direction);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,251 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhPrimaryGeneratorMessenger.cc
+/// \brief Implementation of the EdMedPhPrimaryGeneratorMessenger class
+
+#include "EdMedPhPrimaryGeneratorMessenger.hh"
+#include "EdMedPhPrimaryGeneratorAction.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithoutParameter.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithABool.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhPrimaryGeneratorMessenger::EdMedPhPrimaryGeneratorMessenger(
+                                    EdMedPhPrimaryGeneratorAction* action)
+ : G4UImessenger(),
+   fAction(action)
+{
+  fBeamDirectory = new G4UIdirectory("/EdMedPh/beam/");
+  fBeamDirectory->SetGuidance("Primary beam control.");
+
+  fBatchSizeCmd = new G4UIcmdWithAnInteger("/EdMedPh/beam/batchSize", this);
+  fBatchSizeCmd->SetGuidance("Number of primaries sampled in one go.");
+  fBatchSizeCmd->SetGuidance("Used only with /EdMedPh/random/eventSeeds false:");
+  fBatchSizeCmd->SetGuidance("with per-event seeds (the default) each primary");
+  fBatchSizeCmd->SetGuidance("is sampled alone, after the reseeding.");
+  fBatchSizeCmd->SetParameterName("n", false);
+  fBatchSizeCmd->SetRange("n>0");
+  fBatchSizeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fEnergySpreadCmd 
+    = new G4UIcmdWithADoubleAndUnit("/EdMedPh/beam/energySpread", this);
+  fEnergySpreadCmd->SetGuidance("Gaussian sigma of the beam energy.");
+  fEnergySpreadCmd->SetParameterName("sigmaE", false);
+  fEnergySpreadCmd->SetRange("sigmaE>=0.");
+  fEnergySpreadCmd->SetUnitCategory("Energy");
+  fEnergySpreadCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fSpotSizeCmd = new G4UIcmdWithADoubleAndUnit("/EdMedPh/beam/spotSize", this);
+  fSpotSizeCmd->SetGuidance("Gaussian sigma of the beam spot in X and Y.");
+  fSpotSizeCmd->SetParameterName("sigmaXY", false);
+  fSpotSizeCmd->SetRange("sigmaXY>=0.");
+  fSpotSizeCmd->SetUnitCategory("Length");
+  fSpotSizeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fDivergenceCmd 
+    = new G4UIcmdWithADoubleAndUnit("/EdMedPh/beam/divergence", this);
+  fDivergenceCmd->SetGuidance("Gaussian sigma of the beam angle in X and Y.");
+  fDivergenceCmd->SetParameterName("sigmaTheta", false);
+  fDivergenceCmd->SetRange("sigmaTheta>=0.");
+  fDivergenceCmd->SetUnitCategory("Angle");
+  fDivergenceCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fTableBinsCmd = new G4UIcmdWithAnInteger("/EdMedPh/beam/tableBins", this);
+  fTableBinsCmd->SetGuidance("Number of bins of the normal distribution");
+  fTableBinsCmd->SetGuidance("alias table (over +-5 sigma).");
+  fTableBinsCmd->SetParameterName("n", false);
+  fTableBinsCmd->SetRange("n>0");
+  fTableBinsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  //
+  // Spread-out Bragg peak
+  //
+  fSobpDirectory = new G4UIdirectory("/EdMedPh/beam/sobp/");
+  fSobpDirectory->SetGuidance("Energy layers of a spread-out Bragg peak.");
+  fSobpDirectory->SetGuidance("When layers are defined they replace the");
+  fSobpDirectory->SetGuidance("/gun/energy value.");
+
+  fAddLayerCmd = new G4UIcommand("/EdMedPh/beam/sobp/addLayer", this);
+  fAddLayerCmd->SetGuidance("Add an energy layer with its relative weight.");
+  auto energyPrm = new G4UIparameter("energy", 'd', false);
+  energyPrm->SetParameterRange("energy>0.");
+  fAddLayerCmd->SetParameter(energyPrm);
+  auto unitPrm = new G4UIparameter("unit", 's', false);
+  unitPrm->SetParameterCandidates(
+    G4UIcommand::UnitsList(G4UIcommand::CategoryOf("MeV")));
+  fAddLayerCmd->SetParameter(unitPrm);
+  auto weightPrm = new G4UIparameter("weight", 'd', false);
+  weightPrm->SetParameterRange("weight>0.");
+  fAddLayerCmd->SetParameter(weightPrm);
+  fAddLayerCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fClearLayersCmd 
+    = new G4UIcmdWithoutParameter("/EdMedPh/beam/sobp/clear", this);
+  fClearLayersCmd->SetGuidance("Remove all energy layers.");
+  fClearLayersCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  //
+  // Phase-space replay
+  //
+  fPhaseSpaceCmd = new G4UIcmdWithAString("/EdMedPh/beam/phaseSpace", this);
+  fPhaseSpaceCmd->SetGuidance("Replay the primaries of a phase-space file");
+  fPhaseSpaceCmd->SetGuidance("written with /EdMedPh/phsp/file instead of");
+  fPhaseSpaceCmd->SetGuidance("sampling the beam model; event i replays the");
+  fPhaseSpaceCmd->SetGuidance("i-th recorded event (cyclically).");
+  fPhaseSpaceCmd->SetGuidance("none: go back to the beam model.");
+  fPhaseSpaceCmd->SetParameterName("fileName", false);
+  fPhaseSpaceCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  //
+  // Random numbers
+  //
+  fRandomDirectory = new G4UIdirectory("/EdMedPh/random/");
+  fRandomDirectory->SetGuidance("Seeding of the random engine.");
+  fRandomDirectory->SetGuidance("The engine is chosen with the -e option");
+  fRandomDirectory->SetGuidance("of the executable (ranecu or mixmax).");
+
+  fEventSeedsCmd = new G4UIcmdWithABool("/EdMedPh/random/eventSeeds", this);
+  fEventSeedsCmd->SetGuidance("Reseed the engine at each event from");
+  fEventSeedsCmd->SetGuidance("(run seed, run ID, event ID), so that the");
+  fEventSeedsCmd->SetGuidance("results do not depend on the number of threads.");
+  fEventSeedsCmd->SetGuidance("false: sample the primaries in batches.");
+  fEventSeedsCmd->SetParameterName("eventSeeds", false);
+  fEventSeedsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fRunSeedCmd = new G4UIcmdWithAnInteger("/EdMedPh/random/runSeed", this);
+  fRunSeedCmd->SetGuidance("Seed from which the event seeds are derived.");
+  fRunSeedCmd->SetParameterName("seed", false);
+  fRunSeedCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fReplayEventCmd = new G4UIcommand("/EdMedPh/random/replayEvent", this);
+  fReplayEventCmd->SetGuidance("Re-simulate the given event of a run alone:");
+  fReplayEventCmd->SetGuidance("the events of the next runs are renumbered");
+  fReplayEventCmd->SetGuidance("from eventID and get the seeds they had in");
+  fReplayEventCmd->SetGuidance("run runID, e.g. /run/beamOn 1 replays eventID.");
+  fReplayEventCmd->SetGuidance("Requires the same run seed and options as the");
+  fReplayEventCmd->SetGuidance("original run; -1 goes back to normal runs.");
+  auto eventPrm = new G4UIparameter("eventID", 'i', false);
+  eventPrm->SetParameterRange("eventID>=-1");
+  fReplayEventCmd->SetParameter(eventPrm);
+  auto runPrm = new G4UIparameter("runID", 'i', true);
+  runPrm->SetDefaultValue(0);
+  runPrm->SetParameterRange("runID>=0");
+  fReplayEventCmd->SetParameter(runPrm);
+  fReplayEventCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fFirstEventCmd = new G4UIcmdWithAnInteger("/EdMedPh/random/firstEvent", this);
+  fFirstEventCmd->SetGuidance("Number the events of the next runs from");
+  fFirstEventCmd->SetGuidance("eventID, with their usual seeds. Set by");
+  fFirstEventCmd->SetGuidance("/EdMedPh/run/beamOn for a shard of a job.");
+  fFirstEventCmd->SetParameterName("eventID", false);
+  fFirstEventCmd->SetRange("eventID>=0");
+  fFirstEventCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhPrimaryGeneratorMessenger::~EdMedPhPrimaryGeneratorMessenger()
+{
+  delete fBatchSizeCmd;
+  delete fEnergySpreadCmd;
+  delete fSpotSizeCmd;
+  delete fDivergenceCmd;
+  delete fTableBinsCmd;
+  delete fAddLayerCmd;
+  delete fClearLayersCmd;
+  delete fPhaseSpaceCmd;
+  delete fEventSeedsCmd;
+  delete fRunSeedCmd;
+  delete fReplayEventCmd;
+  delete fFirstEventCmd;
+  delete fRandomDirectory;
+  delete fSobpDirectory;
+  delete fBeamDirectory;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhPrimaryGeneratorMessenger::SetNewValue(G4UIcommand* command,
+                                                   G4String newValue)
+{
+  auto& beamModel = fAction->GetBeamModel();
+
+  if ( command == fBatchSizeCmd ) {
+    fAction->SetBatchSize(fBatchSizeCmd->GetNewIntValue(newValue));
+  }
+  else if ( command == fEnergySpreadCmd ) {
+    beamModel.SetEnergySpread(fEnergySpreadCmd->GetNewDoubleValue(newValue));
+  }
+  else if ( command == fSpotSizeCmd ) {
+    beamModel.SetSpotSize(fSpotSizeCmd->GetNewDoubleValue(newValue));
+  }
+  else if ( command == fDivergenceCmd ) {
+    beamModel.SetDivergence(fDivergenceCmd->GetNewDoubleValue(newValue));
+  }
+  else if ( command == fTableBinsCmd ) {
+    beamModel.SetTableBins(fTableBinsCmd->GetNewIntValue(newValue));
+  }
+  else if ( command == fAddLayerCmd ) {
+    G4double energy, weight;
+    G4String unit;
+    std::istringstream is(newValue);
+    is >> energy >> unit >> weight;
+    beamModel.AddLayer(energy*G4UIcommand::ValueOf(unit), weight);
+  }
+  else if ( command == fClearLayersCmd ) {
+    beamModel.ClearLayers();
+  }
+  else if ( command == fPhaseSpaceCmd ) {
+    fAction->SetPhaseSpaceFile(newValue);
+  }
+  else if ( command == fEventSeedsCmd ) {
+    fAction->SetEventSeeds(fEventSeedsCmd->GetNewBoolValue(newValue));
+  }
+  else if ( command == fRunSeedCmd ) {
+    fAction->SetRunSeed(fRunSeedCmd->GetNewIntValue(newValue));
+  }
+  else if ( command == fReplayEventCmd ) {
+    G4int eventID, runID;
+    std::istringstream is(newValue);
+    is >> eventID >> runID;
+    fAction->SetReplayEvent(eventID, runID);
+  }
+  else if ( command == fFirstEventCmd ) {
+    fAction->SetFirstEvent(fFirstEventCmd->GetNewIntValue(newValue));
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,195 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhProfile.cc
+/// \brief Implementation of the EdMedPhProfile class
+
+#include "EdMedPhProfile.hh"
+
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "G4ParticleDefinition.hh"
+#include "G4VProcess.hh"
+#include "G4LogicalVolume.hh"
+#include "G4VPhysicalVolume.hh"
+#include "G4ios.hh"
+
+#include <algorithm>
+#include <iomanip>
+#include <vector>
+
+namespace {
+  typedef std::pair<G4String, std::pair<G4double, G4double>> Row;
+
+  // one table of the profile, rows (name, steps, time) by decreasing time
+  void PrintTable(const G4String& title, 
+                  const std::map<G4String, std::pair<G4double, G4double>>& sums,
+                  const std::map<G4String, G4double>* tracks,
+                  G4double eventTime, std::size_t maxRows)
+  {
+    std::vector<Row> rows(sums.begin(), sums.end());
+    std::sort(rows.begin(), rows.end(), 
+      [](const Row& a, const Row& b) { return a.second.second > b.second.second; });
+
+    G4cout << "   by " << title << " :" << G4endl;
+    for ( std::size_t i = 0; i < rows.size() && i < maxRows; ++i ) {
+      const auto& name = rows[i].first;
+      auto nofSteps = rows[i].second.first;
+      auto time = rows[i].second.second;
+      G4cout << "     " << std::setw(28) << std::left << name << std::right
+             << std::setw(10) << std::setprecision(4) << time << " s "
+             << std::setw(6) << std::setprecision(3) 
+             << ( eventTime > 0. ? 100.*time/eventTime : 0. ) << " % "
+             << std::setw(12) << std::setprecision(6) << nofSteps << " steps "
+             << std::setw(8) << std::setprecision(3) 
+             << ( nofSteps > 0. ? 1e9*time/nofSteps : 0. ) << " ns/step";
+      if ( tracks ) {
+        auto track = tracks->find(name);
+        G4cout << std::setw(10) << std::setprecision(6)
+               << ( track != tracks->end() ? track->second : 0. ) << " tracks";
+      }
+      G4cout << G4endl;
+    }
+    if ( rows.size() > maxRows ) {
+      G4cout << "     ... " << rows.size() - maxRows << " more" << G4endl;
+    }
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhProfile::EdMedPhProfile()
+ : fLastTime(Clock::now())
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhProfile::~EdMedPhProfile()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhProfile::AddStep(const G4Step* step, G4double time)
+{
+  auto volume = step->GetPreStepPoint()->GetPhysicalVolume();
+  Key key(step->GetTrack()->GetDefinition(),
+          step->GetPostStepPoint()->GetProcessDefinedStep(),
+          volume ? volume->GetLogicalVolume() : nullptr);
+  auto& entry = fEntries[key];
+  entry.nofSteps += 1.;
+  entry.time += time;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhProfile::AddTrack(const G4Track* track)
+{
+  fTracks[track->GetDefinition()] += 1.;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::map<EdMedPhProfile::Names, EdMedPhProfile::Entry> 
+EdMedPhProfile::GetNamedEntries() const
+{
+  // the processes are thread-local, only their names are common
+  auto entries = fNamedEntries;
+  for ( const auto& entry : fEntries ) {
+    auto particle = std::get<0>(entry.first);
+    auto process = std::get<1>(entry.first);
+    auto volume = std::get<2>(entry.first);
+    Names names(particle->GetParticleName(), 
+                process ? process->GetProcessName() : G4String("none"),
+                volume ? volume->GetName() : G4String("none"));
+    auto& named = entries[names];
+    named.nofSteps += entry.second.nofSteps;
+    named.time += entry.second.time;
+  }
+  return entries;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::map<G4String, G4double> EdMedPhProfile::GetNamedTracks() const
+{
+  auto tracks = fNamedTracks;
+  for ( const auto& track : fTracks ) {
+    tracks[track.first->GetParticleName()] += track.second;
+  }
+  return tracks;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhProfile::Merge(const EdMedPhProfile& other)
+{
+  for ( const auto& entry : other.GetNamedEntries() ) {
+    auto& named = fNamedEntries[entry.first];
+    named.nofSteps += entry.second.nofSteps;
+    named.time += entry.second.time;
+  }
+  for ( const auto& track : other.GetNamedTracks() ) {
+    fNamedTracks[track.first] += track.second;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double EdMedPhProfile::GetTime() const
+{
+  G4double time = 0.;
+  for ( const auto& entry : fEntries ) time += entry.second.time;
+  for ( const auto& entry : fNamedEntries ) time += entry.second.time;
+  return time;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhProfile::Print(G4double eventTime) const
+{
+  // (steps, time) summed per particle, process, volume, particle/process
+  std::map<G4String, std::pair<G4double, G4double>> sums[4];
+  for ( const auto& entry : GetNamedEntries() ) {
+    const auto& particle = std::get<0>(entry.first);
+    const auto& process = std::get<1>(entry.first);
+    G4String keys[4] = { particle, process, std::get<2>(entry.first), 
+                         particle + "/" + process };
+    for ( G4int i = 0; i < 4; ++i ) {
+      sums[i][keys[i]].first += entry.second.nofSteps;
+      sums[i][keys[i]].second += entry.second.time;
+    }
+  }
+  auto tracks = GetNamedTracks();
+
+  auto precision = G4cout.precision();
+  PrintTable("particle", sums[0], &tracks, eventTime, 20);
+  PrintTable("process", sums[1], nullptr, eventTime, 20);
+  PrintTable("volume", sums[2], nullptr, eventTime, 20);
+  PrintTable("particle/process", sums[3], nullptr, eventTime, 20);
+  G4cout.precision(precision);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,155 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhProgressReporter.cc
+/// \brief Implementation of the EdMedPhProgressReporter class
+
+#include "EdMedPhProgressReporter.hh"
+
+#include "G4ios.hh"
+
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhProgressReporter* EdMedPhProgressReporter::Instance()
+{
+  static EdMedPhProgressReporter instance;
+  return &instance;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhProgressReporter::EdMedPhProgressReporter()
+ : fNofEvents(0),
+   fInterval(0.),
+   fStopping(false)
+{
+  for ( auto& slot : fSlots ) {
+    slot.nofEvents = 0;
+    slot.lastNofEvents = 0;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhProgressReporter::~EdMedPhProgressReporter()
+{
+  Stop();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhProgressReporter::Start(G4int nofEvents, G4double interval)
+{
+  Stop();
+
+  for ( auto& slot : fSlots ) {
+    slot.nofEvents = 0;
+    slot.lastNofEvents = 0;
+  }
+  fNofEvents = nofEvents;
+  fInterval = interval;
+  if ( fInterval <= 0. ) return;
+
+  fStopping = false;
+  fThread = std::thread([this]() {
+    // G4cout is thread-local, set up only in the threads Geant4 creates
+    G4iosInitialization();
+    using Clock = std::chrono::steady_clock;
+    auto start = Clock::now();
+    auto period = std::chrono::duration<G4double>(fInterval);
+    auto next = start + std::chrono::duration_cast<Clock::duration>(period);
+    std::unique_lock<std::mutex> lock(fMutex);
+    while ( ! fCondition.wait_until(lock, next, [this]{ return fStopping; }) ) {
+      Report();
+      next += std::chrono::duration_cast<Clock::duration>(period);
+    }
+    lock.unlock();
+    G4iosFinalization();
+  });
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhProgressReporter::Stop()
+{
+  if ( ! fThread.joinable() ) return;
+
+  {
+    std::lock_guard<std::mutex> lock(fMutex);
+    fStopping = true;
+  }
+  fCondition.notify_one();
+  fThread.join();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhProgressReporter::Report()
+{
+  // Called every fInterval from the reporter thread
+  G4long nofEvents = 0;
+  G4long nofNewEvents = 0;
+  std::ostringstream rates;
+  for ( G4int i = 0; i < kNofSlots; ++i ) {
+    auto& slot = fSlots[i];
+    auto slotEvents = slot.nofEvents.load(std::memory_order_relaxed);
+    if ( slotEvents == 0 ) continue;
+    auto slotNewEvents = slotEvents - slot.lastNofEvents;
+    slot.lastNofEvents = slotEvents;
+    nofEvents += slotEvents;
+    nofNewEvents += slotNewEvents;
+    if ( i == 0 ) {
+      rates << " master:";
+    }
+    else {
+      rates << " G4WT" << i-1 << ":";
+    }
+    rates << std::lround(slotNewEvents/fInterval);
+  }
+
+  auto rate = nofNewEvents/fInterval;
+  std::ostringstream line;
+  line << std::fixed << std::setprecision(1)
+       << " [progress] " << nofEvents << "/" << fNofEvents << " events (" 
+       << ( fNofEvents > 0 ? 100.*nofEvents/fNofEvents : 0. ) << "%), "
+       << rate << " events/s, ETA ";
+  if ( rate > 0. ) {
+    line << (fNofEvents - nofEvents)/rate << " s";
+  }
+  else {
+    line << "unknown";
+  }
+  line << " |" << rates.str();
+
+  G4cout << line.str() << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
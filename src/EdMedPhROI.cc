@@ -0,0 +1,79 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhROI.cc
+/// \brief Implementation of the EdMedPhROI classes
+
+#include "EdMedPhROI.hh"
+
+#include "G4PhysicalConstants.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhSphereROI::EdMedPhSphereROI(const G4String& name,
+                                   const G4ThreeVector& centre, 
+                                   G4double radius)
+ : EdMedPhROI(name),
+   fCentre(centre),
+   fRadius(radius),
+   fRadius2(radius*radius)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double EdMedPhSphereROI::GetVolume() const
+{
+  return 4./3.*pi*fRadius*fRadius*fRadius;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhBoxROI::EdMedPhBoxROI(const G4String& name,
+                             const G4ThreeVector& centre, 
+                             const G4ThreeVector& size)
+ : EdMedPhROI(name),
+   fLower(centre - 0.5*size),
+   fUpper(centre + 0.5*size)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool EdMedPhBoxROI::Contains(const G4ThreeVector& position) const
+{
+  return position.x() >= fLower.x() && position.x() < fUpper.x()
+      && position.y() >= fLower.y() && position.y() < fUpper.y()
+      && position.z() >= fLower.z() && position.z() < fUpper.z();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double EdMedPhBoxROI::GetVolume() const
+{
+  auto size = fUpper - fLower;
+  return size.x()*size.y()*size.z();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,157 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhRun.cc
+/// \brief Implementation of the EdMedPhRun class
+
+#include "EdMedPhRun.hh"
+#include "EdMedPhROI.hh"
+
+#include "G4Threading.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhRun::EdMedPhRun()
+ : G4Run(),
+   fHitBuffer(nullptr),
+   fEventNtupleId(-1),
+   fROIs(nullptr),
+   fThreadId(G4Threading::G4GetThreadId()),
+   fBusyTime(0.),
+   fProfiling(false)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhRun::~EdMedPhRun()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhRun::SetROIs(const std::vector<EdMedPhROI*>* rois)
+{
+  fROIs = rois;
+  auto size = ( rois ? rois->size() : 0 ) + 1;
+  fROIEdep.assign(size, 0.);
+  fROIEdep2.assign(size, 0.);
+  fEventROIEdep.assign(size, 0.);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhRun::AddROIEdep(const std::vector<G4double>& edep)
+{
+  for ( std::size_t i = 0; i < fEventROIEdep.size(); ++i ) {
+    fEventROIEdep[i] += edep[i];
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhRun::EndROIEvent()
+{
+  // the squares of the whole event, summed over the detectors
+  for ( std::size_t i = 0; i < fEventROIEdep.size(); ++i ) {
+    fROIEdep[i] += fEventROIEdep[i];
+    fROIEdep2[i] += fEventROIEdep[i]*fEventROIEdep[i];
+    fEventROIEdep[i] = 0.;
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhRun::AddProcessHits(const G4String& detector, G4double nofCalls,
+                                G4double nofTimedCalls, G4double time)
+{
+  auto& processHits = fProcessHits[detector];
+  processHits.nofCalls += nofCalls;
+  processHits.nofTimedCalls += nofTimedCalls;
+  processHits.time += time;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double EdMedPhRun::GetNofProcessHits() const
+{
+  G4double nofCalls = 0.;
+  for ( const auto& processHits : fProcessHits ) {
+    nofCalls += processHits.second.nofCalls;
+  }
+  return nofCalls;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double EdMedPhRun::GetProcessHitsTime() const
+{
+  // each detector's sampled mean applies to its own calls
+  G4double time = 0.;
+  for ( const auto& processHits : fProcessHits ) {
+    const auto& sums = processHits.second;
+    if ( sums.nofTimedCalls > 0. ) {
+      time += sums.nofCalls*sums.time/sums.nofTimedCalls;
+    }
+  }
+  return time;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhRun::Merge(const G4Run* run)
+{
+  auto localRun = static_cast<const EdMedPhRun*>(run);
+
+  fDoseGrid.Merge(localRun->GetDoseGrid());
+
+  if ( localRun->fROIEdep.size() == fROIEdep.size() ) {
+    for ( std::size_t i = 0; i < fROIEdep.size(); ++i ) {
+      fROIEdep[i] += localRun->fROIEdep[i];
+      fROIEdep2[i] += localRun->fROIEdep2[i];
+    }
+  }
+  else {
+    G4ExceptionDescription msg;
+    msg << "The regions of interest of a worker differ from the master's," 
+        << G4endl << "their deposits are not merged.";
+    G4Exception("EdMedPhRun::Merge()", "MyCode0014", JustWarning, msg);
+  }
+
+  fThreadLoads.push_back({ localRun->fThreadId, 
+                           localRun->GetNumberOfEvent(), 
+                           localRun->fBusyTime });
+  for ( const auto& processHits : localRun->fProcessHits ) {
+    const auto& sums = processHits.second;
+    AddProcessHits(processHits.first, 
+                   sums.nofCalls, sums.nofTimedCalls, sums.time);
+  }
+  if ( fProfiling && localRun->fProfiling ) {
+    fProfile.Merge(localRun->fProfile);
+  }
+
+  G4Run::Merge(run);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -29,22 +29,146 @@
 /// \brief Implementation of the EdMedPhRunAction class
 
 #include "EdMedPhRunAction.hh"
+#include "EdMedPhRunMessenger.hh"
+#include "EdMedPhRun.hh"
+#include "EdMedPhPrimaryGeneratorAction.hh"
 #include "EdMedPhAnalysis.hh"
-#include "EdMedPhRunAction.hh"
+#include "EdMedPhProgressReporter.hh"
+#include "EdMedPhROI.hh"
+#include "EdMedPhDVH.hh"
+#include "EdMedPhEventSeeds.hh"
+#include "EdMedPhcDetectorConstruction.hh"
 
 #include "G4Run.hh"
 #include "G4RunManager.hh"
+#include "G4AccumulableManager.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4LogicalVolume.hh"
+#include "G4Box.hh"
+#include "G4Threading.hh"
+#include "G4AutoLock.hh"
+#include "G4UImanager.hh"
 #include "G4UnitsTable.hh"
 #include "G4SystemOfUnits.hh"
+#include "Randomize.hh"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <string>
+#include <vector>
+
+#ifndef WIN32
+#include <sys/resource.h>
+#endif
 
 G4String outputFileName;
+
+namespace {
+  // Size in bytes of a file, or -1 if it cannot be opened
+  G4double GetFileSize(const G4String& fileName)
+  {
+    std::ifstream file(fileName, std::ios::binary | std::ios::ate);
+    return file ? static_cast<G4double>(file.tellg()) : -1.;
+  }
+
+  // Peak resident memory of the process in bytes, 0 if not available
+  G4double GetPeakRSS()
+  {
+#ifndef WIN32
+    struct rusage usage;
+    if ( getrusage(RUSAGE_SELF, &usage) == 0 ) {
+#ifdef __APPLE__
+      return usage.ru_maxrss;
+#else
+      return usage.ru_maxrss*1024.;
+#endif
+    }
+#endif
+    return 0.;
+  }
+
+  // File name without its directory
+  G4String GetBaseName(const G4String& fileName)
+  {
+    auto slash = fileName.rfind('/');
+    return slash == std::string::npos 
+      ? fileName : G4String(fileName.substr(slash + 1));
+  }
+
+  // The output files left unmerged by the workers, for the manifest
+  struct ThreadOutput
+  {
+    G4int     threadId;
+    G4int     nofEvents;
+    G4double  nofHitRows;
+  };
+  std::vector<ThreadOutput> threadOutputs;
+  G4Mutex threadOutputsMutex = G4MUTEX_INITIALIZER;
+}
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-EdMedPhRunAction::EdMedPhRunAction()
- : G4UserRunAction()
+EdMedPhRunAction::EdMedPhRunAction(
+                            EdMedPhPrimaryGeneratorAction* primaryGenerator)
+ : G4UserRunAction(),
+   fPrimaryGenerator(primaryGenerator),
+   fMessenger(nullptr),
+   fFillStepNtuple(false),
+   fHitBufferSize(65536),
+   fMergeThreadFiles(true),
+   fNtuplesBooked(false),
+   fColumnarOutput(false),
+   fColumnarCodec(EdMedPhColumnar::kRaw),
+   fColumnarQuantum(0.01*mm),
+   fColumnarRawBytes(0.),
+   fColumnarBytes(0.),
+   fNtupleRows(0.),
+   fNtupleFlushTime(0.),
+   fFillEventNtuple(true),
+   fEventNtupleId(-1),
+   fTumour(nullptr),
+   fThreadSteps(0.),
+   fNofSteps(0.),
+   fProgressInterval(10.*s),
+   fDoseScoring(true),
+   fDoseSize(30.*cm, 30.*cm, 50.*cm),
+   fDVHBins(200),
+   fPhaseSpaceAtPlane(false),
+   fPhaseSpacePlaneOffset(1.*mm),
+   fPlaneWriter(nullptr),
+   fPlaneZ(0.),
+   fShardIndex(0),
+   fNofShards(1),
+   fProfiling(false),
+   fProfile(nullptr)
 { 
-  // set printing event number per each event
-  G4RunManager::GetRunManager()->SetPrintProgress(1);     
+  auto profileEnv = std::getenv("EDMEDPH_PROFILE");
+  fProfiling = profileEnv && *profileEnv && G4String(profileEnv) != "0";
+
+  // default dose grid: 1 x 1 cm^2 columns, 1 mm deep
+  fDoseBins[0] = 30;
+  fDoseBins[1] = 30;
+  fDoseBins[2] = 500;
+
+  // default tumour: the withinTumour() sphere of the ROOT macros
+  fTumour = new EdMedPhSphereROI("tumour", G4ThreeVector(0., 0., 5.*cm), 2.*cm);
+  fROIs.push_back(fTumour);
+
+  fMessenger = new EdMedPhRunMessenger(this);
+
+  // Register accumulables for the step ntuple sink statistics
+  auto accumulableManager = G4AccumulableManager::Instance();
+  accumulableManager->RegisterAccumulable(fNtupleRows);
+  accumulableManager->RegisterAccumulable(fNtupleFlushTime);
+  accumulableManager->RegisterAccumulable(fColumnarRawBytes);
+  accumulableManager->RegisterAccumulable(fColumnarBytes);
+  accumulableManager->RegisterAccumulable(fNofSteps);
+
 
   // Create analysis manager
   // The choice of analysis technology is done via selectin of a namespace
@@ -56,9 +180,6 @@ EdMedPhRunAction::EdMedPhRunAction()
   //analysisManager->SetHistoDirectoryName("histograms");
   //analysisManager->SetNtupleDirectoryName("ntuple");
   analysisManager->SetVerboseLevel(1);
-  analysisManager->SetNtupleMerging(true);
-    // Note: merging ntuples is available only with Root output
-
   // Book histograms, ntuple
   //
   
@@ -69,51 +190,638 @@ EdMedPhRunAction::EdMedPhRunAction()
   // analysisManager->CreateH1("Edep_vs_z_20cm","Edep vs z;Edep (MeV); z(mm)", 100, 0.,20*cm);
   //  analysisManager->CreateH1("Length","trackL in material; z(mm)", 500, 0., 0.5*m);
 
+  // The ntuples are booked at the first run, see BookNtuples()
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhRunAction::~EdMedPhRunAction()
+{
+  delete fMessenger;
+  for ( auto roi : fROIs ) delete roi;
+  delete G4AnalysisManager::Instance();  
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhRunAction::SetDoseBins(G4int nx, G4int ny, G4int nz)
+{
+  fDoseBins[0] = nx;
+  fDoseBins[1] = ny;
+  fDoseBins[2] = nz;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhRunAction::SetTumourCentre(const G4ThreeVector& value)
+{
+  fTumour->SetCentre(value);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhRunAction::SetTumourRadius(G4double value)
+{
+  fTumour->SetRadius(value);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhRunAction::AddSphereROI(const G4String& name,
+                                    const G4ThreeVector& centre, 
+                                    G4double radius)
+{
+  fROIs.push_back(new EdMedPhSphereROI(name, centre, radius));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhRunAction::AddBoxROI(const G4String& name,
+                                 const G4ThreeVector& centre, 
+                                 const G4ThreeVector& size)
+{
+  fROIs.push_back(new EdMedPhBoxROI(name, centre, size));
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhRunAction::ClearROIs()
+{
+  // all but the tumour
+  for ( std::size_t i = 1; i < fROIs.size(); ++i ) delete fROIs[i];
+  fROIs.resize(1);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhRunAction::SetShard(G4int index, G4int count)
+{
+  if ( index >= count ) {
+    G4ExceptionDescription msg;
+    msg << "Shard " << index << " does not exist in a job of " << count 
+        << " shards.";
+    G4Exception("EdMedPhRunAction::SetShard()",
+      "MyCode0017", FatalErrorInArgument, msg);
+    return;
+  }
+  fShardIndex = index;
+  fNofShards = count;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhRunAction::BeamOn(G4int nofEvents)
+{
+  // This shard's contiguous share of the events of the whole job
+  auto first = G4int(G4long(nofEvents)*fShardIndex/fNofShards);
+  auto last = G4int(G4long(nofEvents)*(fShardIndex + 1)/fNofShards);
+
+  // The workers number (and so seed) their events from the first one;
+  // the command is broadcast to them at the start of the run
+  G4UImanager::GetUIpointer()->ApplyCommand(
+    "/EdMedPh/random/firstEvent " + std::to_string(first));
+
+  if ( fNofShards > 1 ) {
+    // an independent master stream, for runs without per-event seeds:
+    // the stream seeded by the user (/random/setSeeds), the same in all
+    // shards up to here, is split by shard
+    auto high = std::uint64_t(G4UniformRand()*4294967296.);
+    auto low = std::uint64_t(G4UniformRand()*4294967296.);
+    long seeds[3];
+    EdMedPhRandom::GetShardSeeds(( high << 32 ) | low, 
+                                 fShardIndex, fNofShards, seeds);
+    G4Random::setTheSeeds(seeds, -1);
+
+    G4cout << "--> Shard " << fShardIndex << " of " << fNofShards 
+           << " : events " << first << " to " << last - 1 << " of " 
+           << nofEvents << G4endl;
+  }
+
+  G4RunManager::GetRunManager()->BeamOn(last - first);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhRunAction::WriteROISummary(const EdMedPhRun* run) const
+{
+  auto fileName = fFileName + "_roi.csv";
+  std::ofstream file(fileName);
+  if ( ! file ) {
+    G4ExceptionDescription msg;
+    msg << "Cannot write " << fileName;
+    G4Exception("EdMedPhRunAction::WriteROISummary()",
+      "MyCode0014", JustWarning, msg);
+    return;
+  }
+
+  // The uncertainty of a sum over N events is sqrt(sum2 - sum^2/N)
+  auto nofEvents = run->GetNumberOfEvent();
+  auto density = 1.*g/cm3;
+
+  G4cout << G4endl << " ----> regions of interest, " << nofEvents 
+         << " events (dose for water)" << G4endl;
+  // full precision, so that EdMedPhc_merge adds the sums of shards exactly
+  file << std::setprecision(std::numeric_limits<G4double>::max_digits10);
+  file << "roi,shape,volume_cm3,edep_MeV,edep_err_MeV,dose_Gy,dose_err_Gy,"
+       << "events,edep2_MeV2\n";
+  for ( std::size_t i = 0; i <= fROIs.size(); ++i ) {
+    auto edep = run->GetROIEdep(i);
+    auto edep2 = run->GetROIEdep2(i);
+    auto edepError = nofEvents > 0 
+      ? std::sqrt(std::max(0., edep2 - edep*edep/nofEvents)) : 0.;
+
+    if ( i == fROIs.size() ) {
+      file << "outside,,," << edep/MeV << "," << edepError/MeV << ",,," 
+           << nofEvents << "," << edep2/(MeV*MeV) << "\n";
+      G4cout << "   outside    : " << G4BestUnit(edep, "Energy") 
+             << " +- " << G4BestUnit(edepError, "Energy") << G4endl;
+      break;
+    }
+
+    auto roi = fROIs[i];
+    auto mass = roi->GetVolume()*density;
+    auto dose = mass > 0. ? edep/mass : 0.;
+    auto doseError = mass > 0. ? edepError/mass : 0.;
+    file << roi->GetName() << "," << roi->GetShape() << "," 
+         << roi->GetVolume()/cm3 << "," << edep/MeV << "," << edepError/MeV 
+         << "," << dose/gray << "," << doseError/gray << "," 
+         << nofEvents << "," << edep2/(MeV*MeV) << "\n";
+    G4cout << "   " << std::setw(10) << std::left << roi->GetName() 
+           << std::right << " : " << G4BestUnit(edep, "Energy") << " +- " 
+           << G4BestUnit(edepError, "Energy") << "  dose " 
+           << G4BestUnit(dose, "Dose") << " +- " 
+           << G4BestUnit(doseError, "Dose") << G4endl;
+  }
+  G4cout << " written to " << fileName << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhRunAction::WriteDVHs(const EdMedPhRun* run) const
+{
+  // the voxel masses are those of water, which the CT phantom is not
+  auto detector = static_cast<const EdMedPhcDetectorConstruction*>(
+    G4RunManager::GetRunManager()->GetUserDetectorConstruction());
+  if ( detector->GetGeometryMode() == EdMedPhcDetectorConstruction::kCT ) {
+    G4ExceptionDescription msg;
+    msg << "The dose-volume histograms assume water voxels," << G4endl;
+    msg << "they are not written for the CT phantom.";
+    G4Exception("EdMedPhRunAction::WriteDVHs()",
+      "MyCode0014", JustWarning, msg);
+    return;
+  }
+
+  const auto& doseGrid = run->GetDoseGrid();
+  auto voxelMass = doseGrid.GetVoxelVolume()*1.*g/cm3;
+
+  // Sort the voxels into the regions, by their centre
+  std::vector<EdMedPhDVH> dvhs;
+  for ( auto roi : fROIs ) dvhs.emplace_back(roi->GetName());
+  dvhs.emplace_back("outside");
+
+  for ( G4int i = 0; i < doseGrid.GetNofVoxels(); ++i ) {
+    auto centre = doseGrid.GetVoxelCentre(i);
+    auto dose = doseGrid.GetEdep(i)/voxelMass;
+    G4bool inside = false;
+    for ( std::size_t j = 0; j < fROIs.size(); ++j ) {
+      if ( fROIs[j]->Contains(centre) ) {
+        dvhs[j].AddVoxel(dose);
+        inside = true;
+      }
+    }
+    if ( ! inside ) dvhs.back().AddVoxel(dose);
+  }
+
+  G4double maxDose = 0.;
+  for ( auto& dvh : dvhs ) {
+    dvh.Finish();
+    maxDose = std::max(maxDose, dvh.GetMaxDose());
+  }
+
+  auto fileName = fFileName + "_dvh.csv";
+  std::ofstream file(fileName);
+  if ( ! file ) {
+    G4ExceptionDescription msg;
+    msg << "Cannot write " << fileName;
+    G4Exception("EdMedPhRunAction::WriteDVHs()",
+      "MyCode0014", JustWarning, msg);
+    return;
+  }
+
+  // volume fraction receiving at least the dose, per region
+  file << "dose_Gy";
+  for ( const auto& dvh : dvhs ) file << "," << dvh.GetName();
+  file << "\n";
+  for ( G4int bin = 0; bin <= fDVHBins; ++bin ) {
+    auto dose = maxDose*bin/fDVHBins;
+    file << dose/gray;
+    for ( const auto& dvh : dvhs ) file << "," << dvh.GetVolumeFraction(dose);
+    file << "\n";
+  }
+
+  G4cout << G4endl << " ----> dose-volume histograms (dose for water)" 
+         << G4endl;
+  for ( const auto& dvh : dvhs ) {
+    if ( dvh.GetNofVoxels() == 0 ) {
+      G4cout << "   " << std::setw(10) << std::left << dvh.GetName() 
+             << std::right << " : no voxel centre inside" << G4endl;
+      continue;
+    }
+    G4cout << "   " << std::setw(10) << std::left << dvh.GetName() 
+           << std::right << " : " << dvh.GetNofVoxels() << " voxels, mean " 
+           << G4BestUnit(dvh.GetMeanDose(), "Dose") << " D98 " 
+           << G4BestUnit(dvh.GetDose(0.98), "Dose") << " D50 " 
+           << G4BestUnit(dvh.GetDose(0.50), "Dose") << " D2 " 
+           << G4BestUnit(dvh.GetDose(0.02), "Dose") << G4endl;
+  }
+  G4cout << " written to " << fileName << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhRunAction::SetPhaseSpaceFile(const G4String& fileName)
+{
+  fPhaseSpaceFileName = ( fileName == "none" ) ? G4String() : fileName;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String EdMedPhRunAction::GetPhaseSpacePartFile(G4int threadId) const
+{
+  return fPhaseSpaceFileName + "_t" + std::to_string(threadId);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4String EdMedPhRunAction::GetColumnarFile(G4int threadId) const
+{
+  G4String fileName = fFileName + "_hits.edmc";
+  if ( threadId >= 0 ) fileName += "_t" + std::to_string(threadId);
+  return fileName;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+std::vector<G4String> EdMedPhRunAction::GetPartFiles(
+                        const EdMedPhRun* run, const G4String& fileName) const
+{
+  // the parts of the workers of this run, the others are stale parts 
+  // left by earlier runs with more threads and are removed
+  std::vector<G4int> threadIds;
+  for ( const auto& load : run->GetThreadLoads() ) {
+    threadIds.push_back(load.threadId);
+  }
+  std::sort(threadIds.begin(), threadIds.end());
+
+  std::vector<G4String> partFileNames;
+  for ( G4int threadId = 0; ; ++threadId ) {
+    auto partFileName = fileName + "_t" + std::to_string(threadId);
+    auto exists = ( GetFileSize(partFileName) >= 0. );
+    auto isWorker 
+      = std::binary_search(threadIds.begin(), threadIds.end(), threadId);
+    if ( ! exists && ( threadIds.empty() || threadId > threadIds.back() ) ) {
+      break;
+    }
+    if ( isWorker && exists ) {
+      partFileNames.push_back(partFileName);
+    }
+    else if ( exists ) {
+      std::remove(partFileName.c_str());
+    }
+  }
+  return partFileNames;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4double EdMedPhRunAction::GetStepFileBytes() const
+{
+  // the merged step file, or the thread files of an unmerged MT run;
+  // the ROOT file also holds the histograms and the event ntuple
+  auto fileType = G4AnalysisManager::Instance()->GetFileType();
+  if ( fMergeThreadFiles || ! G4Threading::IsMultithreadedApplication() ) {
+    return GetFileSize( fColumnarOutput 
+                        ? GetColumnarFile() : fFileName + "." + fileType );
+  }
+
+  G4AutoLock lock(&threadOutputsMutex);
+  G4double bytes = 0.;
+  for ( const auto& output : threadOutputs ) {
+    auto fileName = fColumnarOutput 
+      ? GetColumnarFile(output.threadId)
+      : fFileName + "_t" + std::to_string(output.threadId) + "." + fileType;
+    bytes += std::max(0., GetFileSize(fileName));
+  }
+  return bytes;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhRunAction::WriteManifest() const
+{
+  G4AutoLock lock(&threadOutputsMutex);
+
+  auto fileName = fFileName + "_manifest.csv";
+  std::ofstream file(fileName);
+  if ( ! file ) {
+    G4ExceptionDescription msg;
+    msg << "Cannot write " << fileName;
+    G4Exception("EdMedPhRunAction::WriteManifest()",
+      "MyCode0014", JustWarning, msg);
+    return;
+  }
+
+  // the files are listed relative to the manifest
+  std::sort(threadOutputs.begin(), threadOutputs.end(),
+    [](const ThreadOutput& a, const ThreadOutput& b) 
+      { return a.threadId < b.threadId; });
+  auto fileType = G4AnalysisManager::Instance()->GetFileType();
+  G4double nofHitRows = 0.;
+  file << "thread,events,hit_rows,root_file,hit_file\n";
+  for ( const auto& output : threadOutputs ) {
+    auto rootFile = GetBaseName(fFileName) 
+      + "_t" + std::to_string(output.threadId) + "." + fileType;
+    auto hitFile = fColumnarOutput 
+      ? GetBaseName(GetColumnarFile(output.threadId)) : rootFile;
+    file << output.threadId << "," << output.nofEvents << "," 
+         << output.nofHitRows << "," << rootFile << "," 
+         << ( fFillStepNtuple ? hitFile : G4String() ) << "\n";
+    nofHitRows += output.nofHitRows;
+  }
+
+  G4cout << G4endl << " ----> " << threadOutputs.size() 
+         << " thread output files with " << nofHitRows 
+         << " step rows listed in " << fileName << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhRunAction::PrintThreadLoads(const EdMedPhRun* run, 
+                                        G4double wallTime) const
+{
+  // only the master run of an MT run has worker loads
+  auto loads = run->GetThreadLoads();
+  if ( loads.empty() ) return;
+
+  std::sort(loads.begin(), loads.end(),
+    [](const EdMedPhThreadLoad& a, const EdMedPhThreadLoad& b) 
+      { return a.threadId < b.threadId; });
+
+  G4cout << " busy time per thread (wall time in events) :" << G4endl;
+  G4double minBusy = loads.front().busyTime;
+  G4double maxBusy = 0.;
+  G4double sumBusy = 0.;
+  for ( const auto& load : loads ) {
+    G4cout << "   thread " << std::setw(3) << load.threadId << " : " 
+           << std::setw(8) << load.nofEvents << " events, busy " 
+           << load.busyTime << " s (" 
+           << 100.*load.busyTime/wallTime << " %)" << G4endl;
+    minBusy = std::min(minBusy, load.busyTime);
+    maxBusy = std::max(maxBusy, load.busyTime);
+    sumBusy += load.busyTime;
+  }
+  auto meanBusy = sumBusy/loads.size();
+  G4cout << " busy min/mean/max : " << minBusy << " / " << meanBusy 
+         << " / " << maxBusy << " s, balance (mean/max) : " 
+         << ( maxBusy > 0. ? meanBusy/maxBusy : 1. ) << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhRunAction::PrintProfile(const EdMedPhRun* run) const
+{
+  auto profile = run->GetProfile();
+  if ( ! profile ) return;
+
+  // wall time in events, summed over the workers in MT and tasking runs
+  G4double eventTime = run->GetBusyTime();
+  for ( const auto& load : run->GetThreadLoads() ) {
+    eventTime += load.busyTime;
+  }
+  if ( eventTime <= 0. ) return;
+
+  // ProcessHits() and the step ntuple flushes happen within the steps
+  auto stepTime = profile->GetTime();
+  auto hitsTime = run->GetProcessHitsTime()*1e-9;
+  auto flushTime = fNtupleFlushTime.GetValue();
+  G4cout << " time profile (thread time in events " << eventTime << " s) :" 
+         << G4endl
+         << "   steps                : " << stepTime << " s (" 
+         << 100.*stepTime/eventTime << " %)" << G4endl
+         << "     scoring (estimate) : " << hitsTime << " s ("
+         << 100.*hitsTime/eventTime << " %)" << G4endl
+         << "     step ntuple output : " << flushTime << " s ("
+         << 100.*flushTime/eventTime << " %)" << G4endl
+         << "   outside the steps    : " << eventTime - stepTime << " s ("
+         << 100.*(eventTime - stepTime)/eventTime << " %)" << G4endl;
+  profile->Print(eventTime);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhRunAction::ResolvePlane()
+{
+  // The plane is placed upstream of the calorimeter front face, 
+  // taken from G4LogicalVolumeStore as in EdMedPhPrimaryGeneratorAction
+  //
+  auto calorLV = G4LogicalVolumeStore::GetInstance()->GetVolume("Calorimeter");
+  G4Box* calorBox = nullptr;
+  if ( calorLV ) {
+    calorBox = dynamic_cast<G4Box*>(calorLV->GetSolid());
+  }
+
+  if ( calorBox ) {
+    fPlaneZ = - calorBox->GetZHalfLength() - fPhaseSpacePlaneOffset;
+    fPlaneWriter = &fPhaseSpaceWriter;
+  }
+  else {
+    G4ExceptionDescription msg;
+    msg << "Calorimeter volume of box shape not found." << G4endl;
+    msg << "No particles will be recorded in the phase space.";
+    G4Exception("EdMedPhRunAction::ResolvePlane()",
+      "MyCode0011", JustWarning, msg);
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhRunAction::BookNtuples()
+{
+  // The ntuple merging must be set before the ntuples are booked, this 
+  // is why they are booked only here, once /EdMedPh/output/mergeThreadFiles
+  // could be applied
+  auto analysisManager = G4AnalysisManager::Instance();
+  analysisManager->SetNtupleMerging(fMergeThreadFiles);
+    // Note: merging ntuples is available only with Root output
+
   // Creating ntuple
+  // (filled only with /EdMedPh/output/stepNtuple true, 
+  //  via EdMedPhHitBuffer which relies on this column order)
   //
-  analysisManager->CreateNtuple("EdMedPh", "Edep spacial distribution");
+  auto ntupleId 
+    = analysisManager->CreateNtuple("EdMedPh", "Edep spacial distribution");
+  analysisManager->CreateNtupleFColumn("Edep");
+  analysisManager->CreateNtupleFColumn("X");
+  analysisManager->CreateNtupleFColumn("Y");
+  analysisManager->CreateNtupleFColumn("Z");
+  analysisManager->CreateNtupleIColumn("EventID");
+  analysisManager->FinishNtuple();
+  fHitBuffer.SetNtupleId(ntupleId);
+
+  // Creating the event summary ntuple
+  // (filled by EdMedPhcEventAction, energies in MeV, length in mm)
+  //
+  fEventNtupleId 
+    = analysisManager->CreateNtuple("EdMedPhEvents", "Event summary");
+  analysisManager->CreateNtupleIColumn("EventID");
   analysisManager->CreateNtupleDColumn("Edep");
-  analysisManager->CreateNtupleDColumn("X");
-  analysisManager->CreateNtupleDColumn("Y");
-  analysisManager->CreateNtupleDColumn("Z");
-  analysisManager->CreateNtupleDColumn("EventID");
+  analysisManager->CreateNtupleDColumn("TumourEdep");
+  analysisManager->CreateNtupleDColumn("TrackLength");
+  analysisManager->CreateNtupleDColumn("PrimaryEnergy");
   analysisManager->FinishNtuple();
+  fNtuplesBooked = true;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-EdMedPhRunAction::~EdMedPhRunAction()
+void EdMedPhRunAction::SetMergeThreadFiles(G4bool value)
 {
-  delete G4AnalysisManager::Instance();  
+  if ( value == fMergeThreadFiles ) return;
+
+  if ( fNtuplesBooked ) {
+    G4ExceptionDescription msg;
+    msg << "The ntuples are already booked, the merging of the thread files"
+        << G4endl << "can be changed only before the first run. "
+        << "Command ignored.";
+    G4Exception("EdMedPhRunAction::SetMergeThreadFiles()",
+      "MyCode0018", JustWarning, msg);
+    return;
+  }
+  fMergeThreadFiles = value;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
+G4Run* EdMedPhRunAction::GenerateRun()
+{
+  if ( ! fNtuplesBooked ) BookNtuples();
+
+  auto run = new EdMedPhRun;
+
+  if ( fFillStepNtuple ) {
+    if ( fHitBuffer.GetCapacity() != fHitBufferSize ) {
+      fHitBuffer.SetCapacity(fHitBufferSize);
+    }
+    run->SetHitBuffer(&fHitBuffer);
+  }
+
+  if ( fFillEventNtuple ) {
+    run->SetEventNtupleId(fEventNtupleId);
+  }
+  run->SetROIs(&fROIs);
+
+  if ( fDoseScoring ) {
+    G4ThreeVector lower(-fDoseSize.x()/2, -fDoseSize.y()/2, 0.);
+    G4ThreeVector upper( fDoseSize.x()/2,  fDoseSize.y()/2, fDoseSize.z());
+    run->GetDoseGrid().SetBinning(
+      fDoseBins[0], fDoseBins[1], fDoseBins[2], lower, upper);
+  }
+
+  run->SetProfiling(fProfiling);
+  fProfile = run->GetProfile();
+
+  return run;
+}
 
-void EdMedPhRunAction::BeginOfRunAction(const G4Run* /*run*/)
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+
+void EdMedPhRunAction::BeginOfRunAction(const G4Run* run)
 { 
   //inform the runManager to save random number seed
+  //(not needed to re-run an event, see /EdMedPh/random/replayEvent)
   //G4RunManager::GetRunManager()->SetRandomNumberStore(true);
+
+  // reset accumulables to their initial values
+  G4AccumulableManager::Instance()->Reset();
+  fHitBuffer.ResetStatistics();
+  fThreadSteps = 0.;
+  fTimer.Start();
+
+  // report the progress of the event loops in the background
+  if ( isMaster ) {
+    EdMedPhProgressReporter::Instance()->Start(
+      run->GetNumberOfEventToBeProcessed(), fProgressInterval/s);
+
+    G4AutoLock lock(&threadOutputsMutex);
+    threadOutputs.clear();
+  }
+
+  // open the phase-space file of this thread: in MT mode each worker
+  // writes a part, concatenated by the master in EndOfRunAction()
+  fPlaneWriter = nullptr;
+  EdMedPhPhaseSpaceWriter* primaryWriter = nullptr;
+  auto isMTMaster = isMaster && G4Threading::IsMultithreadedApplication();
+  if ( ! fPhaseSpaceFileName.empty() && ! isMTMaster ) {
+    auto fileName = isMaster 
+      ? fPhaseSpaceFileName 
+      : GetPhaseSpacePartFile(G4Threading::G4GetThreadId());
+    if ( fPhaseSpaceWriter.Open(fileName) ) {
+      if ( fPhaseSpaceAtPlane ) {
+        ResolvePlane();
+      }
+      else {
+        primaryWriter = &fPhaseSpaceWriter;
+      }
+    }
+  }
+
+  // resolve the gun settings for this run
+  if ( fPrimaryGenerator ) {
+    fPrimaryGenerator->SetPhaseSpaceWriter(primaryWriter);
+    fPrimaryGenerator->BeginOfRun();
+  }
   
   // Get analysis manager
   auto analysisManager = G4AnalysisManager::Instance();
 
   // Open an output file
   //
-  G4String fileName;
   if (!outputFileName.size()){
-    fileName = "EdMedPhysics";
+    fFileName = "EdMedPhysics";
   }
   else{
-    fileName = outputFileName;
+    fFileName = outputFileName;
+  }
+    analysisManager->OpenFile(fFileName);
+
+  // open the columnar hit file of this thread, in parts as the phase space
+  fHitBuffer.SetColumnarWriter(nullptr);
+  if ( fFillStepNtuple && fColumnarOutput && ! isMTMaster ) {
+    auto fileName = isMaster 
+      ? GetColumnarFile() : GetColumnarFile(G4Threading::G4GetThreadId());
+    // the deposits are within the world box
+    auto worldLV = G4LogicalVolumeStore::GetInstance()->GetVolume("World");
+    auto worldBox 
+      = worldLV ? dynamic_cast<G4Box*>(worldLV->GetSolid()) : nullptr;
+    auto maxPosition = worldBox 
+      ? std::max({ worldBox->GetXHalfLength(), worldBox->GetYHalfLength(),
+                   worldBox->GetZHalfLength() }) : 0.;
+    fColumnarWriter.SetCodec(fColumnarCodec, fColumnarQuantum, maxPosition);
+    if ( fColumnarWriter.Open(fileName) ) {
+      fHitBuffer.SetColumnarWriter(&fColumnarWriter);
+    }
   }
-    analysisManager->OpenFile(fileName);
   }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void EdMedPhRunAction::EndOfRunAction(const G4Run* /*run*/)
+void EdMedPhRunAction::EndOfRunAction(const G4Run* run)
 {
+  if ( isMaster ) {
+    EdMedPhProgressReporter::Instance()->Stop();
+  }
+
   // print histogram statistics
   //
   auto analysisManager = G4AnalysisManager::Instance();
@@ -139,10 +847,160 @@ void EdMedPhRunAction::EndOfRunAction(const G4Run* /*run*/)
 
   }
 
+  // hand the remaining buffered rows to the analysis manager
+  // and merge the sink statistics into the master
+  //
+  fHitBuffer.Flush();
+  fHitBuffer.SetColumnarWriter(nullptr);
+  if ( fColumnarWriter.IsOpen() ) {
+    fColumnarWriter.Close();
+    fColumnarRawBytes += fColumnarWriter.GetRawBytes();
+    fColumnarBytes += fColumnarWriter.GetWrittenBytes();
+  }
+  if ( ! isMaster && ! fMergeThreadFiles ) {
+    G4AutoLock lock(&threadOutputsMutex);
+    threadOutputs.push_back({ G4Threading::G4GetThreadId(), 
+                              run->GetNumberOfEvent(), 
+                              fHitBuffer.GetNofRows() });
+  }
+  fNtupleRows += fHitBuffer.GetNofRows();
+  fNtupleFlushTime += fHitBuffer.GetFlushTime();
+  fNofSteps += fThreadSteps;
+  G4AccumulableManager::Instance()->Merge();
+
+  if ( fNtupleRows.GetValue() > 0. && ! isMaster ) {
+    G4cout << " Step ntuple for the local thread : " 
+           << fNtupleRows.GetValue() << " rows";
+    if ( fNtupleFlushTime.GetValue() > 0. ) {
+      G4cout << ", " << fNtupleRows.GetValue()/fNtupleFlushTime.GetValue() 
+             << " rows/s";
+    }
+    G4cout << G4endl;
+  }
+
+  // tracking performance of the whole run
+  //
+  fTimer.Stop();
+  auto nofEvents = run->GetNumberOfEvent();
+  if ( isMaster && nofEvents > 0 ) {
+    auto edMedPhRun = static_cast<const EdMedPhRun*>(run);
+    G4cout << G4endl << " ----> " << nofEvents << " events in " 
+           << fTimer.GetRealElapsed() << " s : "
+           << nofEvents/fTimer.GetRealElapsed() << " events/s, "
+           << fNofSteps.GetValue()/nofEvents << " steps/event, "
+           << fNofSteps.GetValue()/fTimer.GetRealElapsed() << " steps/s" 
+           << G4endl;
+    auto nofCalls = edMedPhRun->GetNofProcessHits();
+    auto hitsTime = edMedPhRun->GetProcessHitsTime();
+    G4cout << " ProcessHits : " << nofCalls/nofEvents << " calls/event, "
+           << ( nofCalls > 0. ? hitsTime/nofCalls : 0. ) << " ns/call" 
+           << G4endl;
+    if ( edMedPhRun->GetProcessHits().size() > 1 ) {
+      for ( const auto& processHits : edMedPhRun->GetProcessHits() ) {
+        const auto& sums = processHits.second;
+        G4cout << "   " << processHits.first << " : " 
+               << sums.nofCalls/nofEvents << " calls/event, "
+               << ( sums.nofTimedCalls > 0. 
+                    ? sums.time/sums.nofTimedCalls : 0. ) << " ns/call" 
+               << G4endl;
+      }
+    }
+    G4cout << " peak RSS : " << GetPeakRSS()/(1024.*1024.) << " MB" << G4endl;
+    PrintThreadLoads(edMedPhRun, fTimer.GetRealElapsed());
+    PrintProfile(edMedPhRun);
+  }
+
+  // close the phase-space parts and let the master concatenate them
+  //
+  fPhaseSpaceWriter.Close();
+  if ( isMaster && G4Threading::IsMultithreadedApplication() 
+       && ! fPhaseSpaceFileName.empty() ) {
+    EdMedPhPhaseSpaceWriter::MergeFiles(fPhaseSpaceFileName, 
+      GetPartFiles(static_cast<const EdMedPhRun*>(run), fPhaseSpaceFileName));
+  }
+  if ( isMaster && ! fPhaseSpaceFileName.empty() ) {
+    G4cout << G4endl << " ----> phase space written to " 
+           << fPhaseSpaceFileName << " (" 
+           << GetFileSize(fPhaseSpaceFileName) << " bytes)" << G4endl;
+  }
+
+  // concatenate the columnar hit parts, or list all the thread files
+  //
+  auto isMTMaster = isMaster && G4Threading::IsMultithreadedApplication();
+  if ( isMTMaster && ! fMergeThreadFiles ) {
+    WriteManifest();
+  }
+  else if ( isMTMaster && fFillStepNtuple && fColumnarOutput ) {
+    EdMedPhColumnarWriter::MergeFiles(GetColumnarFile(), 
+      GetPartFiles(static_cast<const EdMedPhRun*>(run), GetColumnarFile()));
+  }
+
+  // write the dose map merged over all threads
+  //
+  auto edMedPhRun = static_cast<const EdMedPhRun*>(run);
+  const auto& doseGrid = edMedPhRun->GetDoseGrid();
+  if ( isMaster && doseGrid.IsEnabled() ) {
+    auto doseFileName = fFileName + "_dose.bin";
+    doseGrid.Write(doseFileName);
+
+    G4cout << G4endl << " ----> dose map " 
+           << doseGrid.GetNx() << " x " << doseGrid.GetNy() << " x " 
+           << doseGrid.GetNz() << " voxels written to " << doseFileName 
+           << G4endl
+           << " E deposited in grid : " 
+           << G4BestUnit(doseGrid.GetTotalEdep(), "Energy") << G4endl;
+  }
+
+  // write the regions of interest summary
+  //
+  if ( isMaster ) {
+    WriteROISummary(edMedPhRun);
+    if ( doseGrid.IsEnabled() && fDVHBins > 0 ) {
+      WriteDVHs(edMedPhRun);
+    }
+  }
+
   // save histograms & ntuple
   //
   analysisManager->Write();
   analysisManager->CloseFile();
+
+  // report the step ntuple sink figures for the whole run
+  //
+  auto nofRows = fNtupleRows.GetValue();
+  auto flushTime = fNtupleFlushTime.GetValue();
+  if ( isMaster && nofRows > 0. ) {
+    G4cout << G4endl << " ----> step ntuple : " << nofRows << " rows ("
+           << ( fColumnarOutput ? "columnar chunks" : "analysis manager fills" )
+           << ")" << G4endl;
+    if ( flushTime > 0. ) {
+      G4cout << " sink throughput : " << nofRows/flushTime 
+             << " rows/s per thread, " << 1e9*flushTime/nofRows 
+             << " ns/row" << G4endl;
+    }
+    if ( fColumnarBytes.GetValue() > 0. ) {
+      G4cout << " columnar codec : " 
+             << EdMedPhColumnar::GetCodecName(fColumnarCodec)
+             << ", compression ratio " 
+             << fColumnarRawBytes.GetValue()/fColumnarBytes.GetValue();
+      if ( flushTime > 0. ) {
+        G4cout << ", write throughput " 
+               << fColumnarRawBytes.GetValue()/flushTime/1e6
+               << " MB/s of raw columns per thread";
+      }
+      G4cout << G4endl;
+    }
+    auto fileBytes = GetStepFileBytes();
+    if ( fileBytes > 0. ) {
+      G4cout << " on disk : " << fileBytes/nofRows << " bytes/row (" 
+             << ( fColumnarOutput ? "columnar hit file" 
+                                  : "ROOT file, with the histograms" )
+             << ( ! fMergeThreadFiles 
+                  && G4Threading::IsMultithreadedApplication() 
+                  ? ", all threads" : "" )
+             << ")" << G4endl;
+    }
+  }
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -0,0 +1,468 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhRunMessenger.cc
+/// \brief Implementation of the EdMedPhRunMessenger class
+
+#include "EdMedPhRunMessenger.hh"
+#include "EdMedPhRunAction.hh"
+
+#include "G4UIdirectory.hh"
+#include "G4UIcommand.hh"
+#include "G4UIparameter.hh"
+#include "G4UIcmdWithABool.hh"
+#include "G4UIcmdWithAnInteger.hh"
+#include "G4UIcmdWith3VectorAndUnit.hh"
+#include "G4UIcmdWithAString.hh"
+#include "G4UIcmdWithADoubleAndUnit.hh"
+#include "G4UIcmdWithoutParameter.hh"
+
+#include <sstream>
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhRunMessenger::EdMedPhRunMessenger(EdMedPhRunAction* runAction)
+ : G4UImessenger(),
+   fRunAction(runAction)
+{
+  fTopDirectory = new G4UIdirectory("/EdMedPh/");
+  fTopDirectory->SetGuidance("EdMedPhysics application commands.");
+
+  //
+  // Output
+  //
+  fOutputDirectory = new G4UIdirectory("/EdMedPh/output/");
+  fOutputDirectory->SetGuidance("Output control.");
+
+  fStepNtupleCmd = new G4UIcmdWithABool("/EdMedPh/output/stepNtuple", this);
+  fStepNtupleCmd->SetGuidance("Write one ntuple row per energy deposit.");
+  fStepNtupleCmd->SetGuidance("Needed only by the step level ROOT macros,");
+  fStepNtupleCmd->SetGuidance("the dose map is scored independently.");
+  fStepNtupleCmd->SetParameterName("flag", false);
+  fStepNtupleCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fHitBufferSizeCmd 
+    = new G4UIcmdWithAnInteger("/EdMedPh/output/hitBufferSize", this);
+  fHitBufferSizeCmd->SetGuidance("Number of step ntuple rows buffered per");
+  fHitBufferSizeCmd->SetGuidance("thread before they are written out.");
+  fHitBufferSizeCmd->SetParameterName("rows", false);
+  fHitBufferSizeCmd->SetRange("rows>0");
+  fHitBufferSizeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fStepFormatCmd = new G4UIcmdWithAString("/EdMedPh/output/stepFormat", this);
+  fStepFormatCmd->SetGuidance("Sink of the step rows:");
+  fStepFormatCmd->SetGuidance("  root: the EdMedPh ntuple of the analysis file,");
+  fStepFormatCmd->SetGuidance("  columnar: <output>_hits.edmc, read without ROOT");
+  fStepFormatCmd->SetGuidance("  by analysis/include/EdMedPhColumnarReader.hh.");
+  fStepFormatCmd->SetParameterName("format", false);
+  fStepFormatCmd->SetCandidates("root columnar");
+  fStepFormatCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fMergeThreadFilesCmd 
+    = new G4UIcmdWithABool("/EdMedPh/output/mergeThreadFiles", this);
+  fMergeThreadFilesCmd->SetGuidance("Merge the ntuples and columnar hits of");
+  fMergeThreadFilesCmd->SetGuidance("the workers into one file at the end of");
+  fMergeThreadFilesCmd->SetGuidance("an MT run (default), or keep one file per");
+  fMergeThreadFilesCmd->SetGuidance("thread listed in <output>_manifest.csv.");
+  fMergeThreadFilesCmd->SetGuidance("Only before the first run, which books");
+  fMergeThreadFilesCmd->SetGuidance("the ntuples.");
+  fMergeThreadFilesCmd->SetParameterName("flag", false);
+  fMergeThreadFilesCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fCodecCmd = new G4UIcmdWithAString("/EdMedPh/output/codec", this);
+  fCodecCmd->SetGuidance("Encoding of the columnar hit file chunks:");
+  fCodecCmd->SetGuidance("  raw: the float and int columns as they are,");
+  fCodecCmd->SetGuidance("  packed: positions quantized, positions and EventID");
+  fCodecCmd->SetGuidance("          delta and varint encoded,");
+  fCodecCmd->SetGuidance("  zlib: packed then deflated (if built with zlib).");
+  fCodecCmd->SetGuidance("The chunk size is /EdMedPh/output/hitBufferSize.");
+  fCodecCmd->SetParameterName("codec", false);
+  fCodecCmd->SetCandidates("raw packed zlib");
+  fCodecCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fQuantumCmd 
+    = new G4UIcmdWithADoubleAndUnit("/EdMedPh/output/quantum", this);
+  fQuantumCmd->SetGuidance("Step of the positions in packed chunks.");
+  fQuantumCmd->SetGuidance("Raised if too small for the world size, the");
+  fQuantumCmd->SetGuidance("positions being packed as 32 bit integers.");
+  fQuantumCmd->SetParameterName("quantum", false);
+  fQuantumCmd->SetRange("quantum>0.");
+  fQuantumCmd->SetUnitCategory("Length");
+  fQuantumCmd->SetDefaultUnit("mm");
+  fQuantumCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fEventNtupleCmd = new G4UIcmdWithABool("/EdMedPh/output/eventNtuple", this);
+  fEventNtupleCmd->SetGuidance("Write one EdMedPhEvents ntuple row per event:");
+  fEventNtupleCmd->SetGuidance("Edep, TumourEdep, TrackLength, PrimaryEnergy.");
+  fEventNtupleCmd->SetParameterName("flag", false);
+  fEventNtupleCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  //
+  // Tumour
+  //
+  fTumourDirectory = new G4UIdirectory("/EdMedPh/tumour/");
+  fTumourDirectory->SetGuidance("Tumour sphere of the event summary.");
+
+  fTumourCentreCmd 
+    = new G4UIcmdWith3VectorAndUnit("/EdMedPh/tumour/centre", this);
+  fTumourCentreCmd->SetGuidance("Set the centre of the tumour sphere.");
+  fTumourCentreCmd->SetGuidance("X and Y from the beam axis, Z is the depth");
+  fTumourCentreCmd->SetGuidance("from the phantom entrance face.");
+  fTumourCentreCmd->SetParameterName("x", "y", "depth", false);
+  fTumourCentreCmd->SetUnitCategory("Length");
+  fTumourCentreCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fTumourRadiusCmd 
+    = new G4UIcmdWithADoubleAndUnit("/EdMedPh/tumour/radius", this);
+  fTumourRadiusCmd->SetGuidance("Set the radius of the tumour sphere.");
+  fTumourRadiusCmd->SetParameterName("radius", false);
+  fTumourRadiusCmd->SetRange("radius>=0.");
+  fTumourRadiusCmd->SetUnitCategory("Length");
+  fTumourRadiusCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  //
+  // Regions of interest
+  //
+  fROIDirectory = new G4UIdirectory("/EdMedPh/roi/");
+  fROIDirectory->SetGuidance("Regions of interest scored during the run,");
+  fROIDirectory->SetGuidance("in addition to the tumour. Positions as for");
+  fROIDirectory->SetGuidance("/EdMedPh/tumour/centre. The energy and dose");
+  fROIDirectory->SetGuidance("in each region, and outside all of them, are");
+  fROIDirectory->SetGuidance("written with their uncertainties to");
+  fROIDirectory->SetGuidance("<output>_roi.csv.");
+
+  fSphereROICmd = new G4UIcommand("/EdMedPh/roi/sphere", this);
+  fSphereROICmd->SetGuidance("Add a spherical region of interest.");
+  fSphereROICmd->SetParameter(new G4UIparameter("name", 's', false));
+  fSphereROICmd->SetParameter(new G4UIparameter("x", 'd', false));
+  fSphereROICmd->SetParameter(new G4UIparameter("y", 'd', false));
+  fSphereROICmd->SetParameter(new G4UIparameter("depth", 'd', false));
+  auto radiusPrm = new G4UIparameter("radius", 'd', false);
+  radiusPrm->SetParameterRange("radius>0.");
+  fSphereROICmd->SetParameter(radiusPrm);
+  auto sphereUnitPrm = new G4UIparameter("unit", 's', true);
+  sphereUnitPrm->SetDefaultValue("cm");
+  fSphereROICmd->SetParameter(sphereUnitPrm);
+  fSphereROICmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fBoxROICmd = new G4UIcommand("/EdMedPh/roi/box", this);
+  fBoxROICmd->SetGuidance("Add a box region of interest, given its centre");
+  fBoxROICmd->SetGuidance("and its full sizes.");
+  fBoxROICmd->SetParameter(new G4UIparameter("name", 's', false));
+  fBoxROICmd->SetParameter(new G4UIparameter("x", 'd', false));
+  fBoxROICmd->SetParameter(new G4UIparameter("y", 'd', false));
+  fBoxROICmd->SetParameter(new G4UIparameter("depth", 'd', false));
+  for ( auto name : { "sizeX", "sizeY", "sizeZ" } ) {
+    auto sizePrm = new G4UIparameter(name, 'd', false);
+    sizePrm->SetParameterRange((G4String(name) + ">0.").c_str());
+    fBoxROICmd->SetParameter(sizePrm);
+  }
+  auto boxUnitPrm = new G4UIparameter("unit", 's', true);
+  boxUnitPrm->SetDefaultValue("cm");
+  fBoxROICmd->SetParameter(boxUnitPrm);
+  fBoxROICmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fClearROIsCmd = new G4UIcmdWithoutParameter("/EdMedPh/roi/clear", this);
+  fClearROIsCmd->SetGuidance("Remove all regions of interest but the tumour.");
+  fClearROIsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  //
+  // Dose grid
+  //
+  fDoseDirectory = new G4UIdirectory("/EdMedPh/dose/");
+  fDoseDirectory->SetGuidance("Voxelised dose scoring.");
+
+  fDoseScoringCmd = new G4UIcmdWithABool("/EdMedPh/dose/scoring", this);
+  fDoseScoringCmd->SetGuidance("Switch the voxelised dose scoring on/off.");
+  fDoseScoringCmd->SetGuidance("The dose map is written to <output>_dose.bin.");
+  fDoseScoringCmd->SetParameterName("flag", false);
+  fDoseScoringCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fDoseBinsCmd = new G4UIcommand("/EdMedPh/dose/bins", this);
+  fDoseBinsCmd->SetGuidance("Set the number of voxels along X, Y and Z.");
+  auto nxPrm = new G4UIparameter("nx", 'i', false);
+  nxPrm->SetParameterRange("nx>0");
+  fDoseBinsCmd->SetParameter(nxPrm);
+  auto nyPrm = new G4UIparameter("ny", 'i', false);
+  nyPrm->SetParameterRange("ny>0");
+  fDoseBinsCmd->SetParameter(nyPrm);
+  auto nzPrm = new G4UIparameter("nz", 'i', false);
+  nzPrm->SetParameterRange("nz>0");
+  fDoseBinsCmd->SetParameter(nzPrm);
+  fDoseBinsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fDoseSizeCmd = new G4UIcmdWith3VectorAndUnit("/EdMedPh/dose/size", this);
+  fDoseSizeCmd->SetGuidance("Set the full size of the dose grid.");
+  fDoseSizeCmd->SetGuidance("X and Y are centred on the beam axis,");
+  fDoseSizeCmd->SetGuidance("Z starts at the phantom entrance face.");
+  fDoseSizeCmd->SetParameterName("sizeX", "sizeY", "sizeZ", false);
+  fDoseSizeCmd->SetRange("sizeX>0 && sizeY>0 && sizeZ>0");
+  fDoseSizeCmd->SetUnitCategory("Length");
+  fDoseSizeCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fDVHBinsCmd = new G4UIcmdWithAnInteger("/EdMedPh/dose/dvhBins", this);
+  fDVHBinsCmd->SetGuidance("Number of dose points of the dose-volume");
+  fDVHBinsCmd->SetGuidance("histograms of the regions of interest,");
+  fDVHBinsCmd->SetGuidance("computed from the dose grid at the end of run.");
+  fDVHBinsCmd->SetGuidance("The voxel doses are for water: no histograms");
+  fDVHBinsCmd->SetGuidance("are written with the CT phantom.");
+  fDVHBinsCmd->SetGuidance("0: no dose-volume histograms.");
+  fDVHBinsCmd->SetParameterName("nBins", false);
+  fDVHBinsCmd->SetRange("nBins>=0");
+  fDVHBinsCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  //
+  // Phase space
+  //
+  fPhaseSpaceDirectory = new G4UIdirectory("/EdMedPh/phsp/");
+  fPhaseSpaceDirectory->SetGuidance("Phase-space file recording.");
+  fPhaseSpaceDirectory->SetGuidance("Replay with /EdMedPh/beam/phaseSpace.");
+
+  fPhaseSpaceFileCmd = new G4UIcmdWithAString("/EdMedPh/phsp/file", this);
+  fPhaseSpaceFileCmd->SetGuidance("Record a phase-space file in the next runs.");
+  fPhaseSpaceFileCmd->SetGuidance("none: stop recording.");
+  fPhaseSpaceFileCmd->SetGuidance("In MT runs each worker writes a part file,");
+  fPhaseSpaceFileCmd->SetGuidance("concatenated by the master at end of run.");
+  fPhaseSpaceFileCmd->SetParameterName("fileName", false);
+  fPhaseSpaceFileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fPhaseSpaceSourceCmd = new G4UIcmdWithAString("/EdMedPh/phsp/source", this);
+  fPhaseSpaceSourceCmd->SetGuidance("Particles to record:");
+  fPhaseSpaceSourceCmd->SetGuidance("  primaries: the generated primaries,");
+  fPhaseSpaceSourceCmd->SetGuidance("  plane: all particles crossing a plane");
+  fPhaseSpaceSourceCmd->SetGuidance("  upstream of the calorimeter.");
+  fPhaseSpaceSourceCmd->SetParameterName("source", false);
+  fPhaseSpaceSourceCmd->SetCandidates("primaries plane");
+  fPhaseSpaceSourceCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fPlaneOffsetCmd 
+    = new G4UIcmdWithADoubleAndUnit("/EdMedPh/phsp/planeOffset", this);
+  fPlaneOffsetCmd->SetGuidance("Distance of the recording plane upstream of");
+  fPlaneOffsetCmd->SetGuidance("the calorimeter front face.");
+  fPlaneOffsetCmd->SetParameterName("offset", false);
+  fPlaneOffsetCmd->SetRange("offset>0.");
+  fPlaneOffsetCmd->SetUnitCategory("Length");
+  fPlaneOffsetCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  //
+  // Progress
+  //
+  fProgressDirectory = new G4UIdirectory("/EdMedPh/progress/");
+  fProgressDirectory->SetGuidance("Run progress report.");
+
+  fProgressIntervalCmd 
+    = new G4UIcmdWithADoubleAndUnit("/EdMedPh/progress/interval", this);
+  fProgressIntervalCmd->SetGuidance("Print the events done, events/s, ETA and");
+  fProgressIntervalCmd->SetGuidance("per-thread rates at this time interval.");
+  fProgressIntervalCmd->SetGuidance("0: no progress report.");
+  fProgressIntervalCmd->SetParameterName("interval", false);
+  fProgressIntervalCmd->SetRange("interval>=0.");
+  fProgressIntervalCmd->SetUnitCategory("Time");
+  fProgressIntervalCmd->SetDefaultUnit("s");
+  fProgressIntervalCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  //
+  // Job splitting
+  //
+  fRunDirectory = new G4UIdirectory("/EdMedPh/run/");
+  fRunDirectory->SetGuidance("Splitting of a job over several processes.");
+
+  fShardCmd = new G4UIcommand("/EdMedPh/run/shard", this);
+  fShardCmd->SetGuidance("Make this process the shard index (from 0) of a");
+  fShardCmd->SetGuidance("job split in count processes, also set with the");
+  fShardCmd->SetGuidance("-s index/count option of the executable.");
+  fShardCmd->SetGuidance("The outputs of the shards are combined with");
+  fShardCmd->SetGuidance("EdMedPhc_merge.");
+  auto indexPrm = new G4UIparameter("index", 'i', false);
+  indexPrm->SetParameterRange("index>=0");
+  fShardCmd->SetParameter(indexPrm);
+  auto countPrm = new G4UIparameter("count", 'i', false);
+  countPrm->SetParameterRange("count>0");
+  fShardCmd->SetParameter(countPrm);
+  fShardCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+
+  fBeamOnCmd = new G4UIcmdWithAnInteger("/EdMedPh/run/beamOn", this);
+  fBeamOnCmd->SetGuidance("Start a run of nofEvents events for the whole");
+  fBeamOnCmd->SetGuidance("job: a shard simulates only its share of them,");
+  fBeamOnCmd->SetGuidance("numbered and seeded as in a single process.");
+  fBeamOnCmd->SetGuidance("Without shards, the same as /run/beamOn.");
+  fBeamOnCmd->SetParameterName("nofEvents", false);
+  fBeamOnCmd->SetRange("nofEvents>=0");
+  fBeamOnCmd->AvailableForStates(G4State_Idle);
+  fBeamOnCmd->SetToBeBroadcasted(false);
+
+  //
+  // Profiling
+  //
+  fProfileDirectory = new G4UIdirectory("/EdMedPh/profile/");
+  fProfileDirectory->SetGuidance("Time profile of the steps.");
+
+  fProfileCmd = new G4UIcmdWithABool("/EdMedPh/profile/enable", this);
+  fProfileCmd->SetGuidance("Time the steps per particle, process and volume");
+  fProfileCmd->SetGuidance("and print the profile at the end of the run.");
+  fProfileCmd->SetGuidance("Also enabled by a non-zero EDMEDPH_PROFILE.");
+  fProfileCmd->SetParameterName("enable", false);
+  fProfileCmd->AvailableForStates(G4State_PreInit, G4State_Idle);
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhRunMessenger::~EdMedPhRunMessenger()
+{
+  delete fStepNtupleCmd;
+  delete fHitBufferSizeCmd;
+  delete fStepFormatCmd;
+  delete fMergeThreadFilesCmd;
+  delete fCodecCmd;
+  delete fQuantumCmd;
+  delete fEventNtupleCmd;
+  delete fTumourCentreCmd;
+  delete fTumourRadiusCmd;
+  delete fSphereROICmd;
+  delete fBoxROICmd;
+  delete fClearROIsCmd;
+  delete fDoseScoringCmd;
+  delete fDoseBinsCmd;
+  delete fDoseSizeCmd;
+  delete fDVHBinsCmd;
+  delete fPhaseSpaceFileCmd;
+  delete fPhaseSpaceSourceCmd;
+  delete fPlaneOffsetCmd;
+  delete fProgressIntervalCmd;
+  delete fShardCmd;
+  delete fBeamOnCmd;
+  delete fProfileCmd;
+  delete fPhaseSpaceDirectory;
+  delete fProgressDirectory;
+  delete fRunDirectory;
+  delete fProfileDirectory;
+  delete fTumourDirectory;
+  delete fROIDirectory;
+  delete fDoseDirectory;
+  delete fOutputDirectory;
+  delete fTopDirectory;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhRunMessenger::SetNewValue(G4UIcommand* command, G4String newValue)
+{
+  if ( command == fStepNtupleCmd ) {
+    fRunAction->SetFillStepNtuple(fStepNtupleCmd->GetNewBoolValue(newValue));
+  }
+  else if ( command == fHitBufferSizeCmd ) {
+    fRunAction->SetHitBufferSize(fHitBufferSizeCmd->GetNewIntValue(newValue));
+  }
+  else if ( command == fStepFormatCmd ) {
+    fRunAction->SetColumnarOutput(newValue == "columnar");
+  }
+  else if ( command == fMergeThreadFilesCmd ) {
+    fRunAction->SetMergeThreadFiles(
+      fMergeThreadFilesCmd->GetNewBoolValue(newValue));
+  }
+  else if ( command == fCodecCmd ) {
+    G4int codec = EdMedPhColumnar::kRaw;
+    if ( newValue == "packed" ) codec = EdMedPhColumnar::kPacked;
+    if ( newValue == "zlib" ) codec = EdMedPhColumnar::kPackedZlib;
+    fRunAction->SetColumnarCodec(codec);
+  }
+  else if ( command == fQuantumCmd ) {
+    fRunAction->SetColumnarQuantum(fQuantumCmd->GetNewDoubleValue(newValue));
+  }
+  else if ( command == fEventNtupleCmd ) {
+    fRunAction->SetFillEventNtuple(fEventNtupleCmd->GetNewBoolValue(newValue));
+  }
+  else if ( command == fTumourCentreCmd ) {
+    fRunAction->SetTumourCentre(fTumourCentreCmd->GetNew3VectorValue(newValue));
+  }
+  else if ( command == fTumourRadiusCmd ) {
+    fRunAction->SetTumourRadius(fTumourRadiusCmd->GetNewDoubleValue(newValue));
+  }
+  else if ( command == fSphereROICmd ) {
+    G4String name, unit;
+    G4double x, y, z, radius;
+    std::istringstream is(newValue);
+    is >> name >> x >> y >> z >> radius >> unit;
+    auto value = G4UIcommand::ValueOf(unit);
+    fRunAction->AddSphereROI(
+      name, G4ThreeVector(x, y, z)*value, radius*value);
+  }
+  else if ( command == fBoxROICmd ) {
+    G4String name, unit;
+    G4double x, y, z, sx, sy, sz;
+    std::istringstream is(newValue);
+    is >> name >> x >> y >> z >> sx >> sy >> sz >> unit;
+    auto value = G4UIcommand::ValueOf(unit);
+    fRunAction->AddBoxROI(
+      name, G4ThreeVector(x, y, z)*value, G4ThreeVector(sx, sy, sz)*value);
+  }
+  else if ( command == fClearROIsCmd ) {
+    fRunAction->ClearROIs();
+  }
+  else if ( command == fDoseScoringCmd ) {
+    fRunAction->SetDoseScoring(fDoseScoringCmd->GetNewBoolValue(newValue));
+  }
+  else if ( command == fDoseBinsCmd ) {
+    G4int nx, ny, nz;
+    std::istringstream is(newValue);
+    is >> nx >> ny >> nz;
+    fRunAction->SetDoseBins(nx, ny, nz);
+  }
+  else if ( command == fDoseSizeCmd ) {
+    fRunAction->SetDoseSize(fDoseSizeCmd->GetNew3VectorValue(newValue));
+  }
+  else if ( command == fDVHBinsCmd ) {
+    fRunAction->SetDVHBins(fDVHBinsCmd->GetNewIntValue(newValue));
+  }
+  else if ( command == fPhaseSpaceFileCmd ) {
+    fRunAction->SetPhaseSpaceFile(newValue);
+  }
+  else if ( command == fPhaseSpaceSourceCmd ) {
+    fRunAction->SetPhaseSpaceAtPlane(newValue == "plane");
+  }
+  else if ( command == fPlaneOffsetCmd ) {
+    fRunAction->SetPhaseSpacePlaneOffset(
+      fPlaneOffsetCmd->GetNewDoubleValue(newValue));
+  }
+  else if ( command == fProgressIntervalCmd ) {
+    fRunAction->SetProgressInterval(
+      fProgressIntervalCmd->GetNewDoubleValue(newValue));
+  }
+  else if ( command == fShardCmd ) {
+    G4int index, count;
+    std::istringstream is(newValue);
+    is >> index >> count;
+    fRunAction->SetShard(index, count);
+  }
+  else if ( command == fBeamOnCmd ) {
+    fRunAction->BeamOn(fBeamOnCmd->GetNewIntValue(newValue));
+  }
+  else if ( command == fProfileCmd ) {
+    fRunAction->SetProfiling(fProfileCmd->GetNewBoolValue(newValue));
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
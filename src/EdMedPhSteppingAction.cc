@@ -0,0 +1,80 @@
+//
+// ********************************************************************
+// * License and Disclaimer                                           *
+// *                                                                  *
+// * The  Geant4 software  is  copyright of the Copyright Holders  of *
+// * the Geant4 Collaboration.  It is provided  under  the terms  and *
+// * conditions of the Geant4 Software License,  included in the file *
+// * LICENSE and available at  http://cern.ch/geant4/license .  These *
+// * include a list of copyright holders.                             *
+// *                                                                  *
+// * Neither the authors of this software system, nor their employing *
+// * institutes,nor the agencies providing financial support for this *
+// * work  make  any representation or  warranty, express or implied, *
+// * regarding  this  software system or assume any liability for its *
+// * use.  Please see the license in the file  LICENSE  and URL above *
+// * for the full disclaimer and the limitation of liability.         *
+// *                                                                  *
+// * This  code  implementation is the result of  the  scientific and *
+// * technical work of the GEANT4 collaboration.                      *
+// * By using,  copying,  modifying or  distributing the software (or *
+// * any work based  on the software)  you  agree  to acknowledge its *
+// * use  in  resulting  scientific  publications,  and indicate your *
+// * acceptance of all terms of the Geant4 Software license.          *
+// ********************************************************************
+//
+//
+/// \file EdMedPhSteppingAction.cc
+/// \brief Implementation of the EdMedPhSteppingAction class
+
+#include "EdMedPhSteppingAction.hh"
+#include "EdMedPhRunAction.hh"
+#include "EdMedPhPhaseSpaceWriter.hh"
+#include "EdMedPhProfile.hh"
+
+#include "G4Step.hh"
+#include "G4Track.hh"
+#include "G4Event.hh"
+#include "G4EventManager.hh"
+#include "G4ParticleDefinition.hh"
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhSteppingAction::EdMedPhSteppingAction(
+                         EdMedPhRunAction* runAction)
+ : G4UserSteppingAction(),
+   fRunAction(runAction)
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+EdMedPhSteppingAction::~EdMedPhSteppingAction()
+{}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhSteppingAction::UserSteppingAction(const G4Step* step)
+{
+  fRunAction->CountStep();
+  if ( auto profile = fRunAction->GetProfile() ) profile->EndStep(step);
+
+  auto writer = fRunAction->GetPlaneWriter();
+  if ( ! writer ) return;
+
+  auto zPlane = fRunAction->GetPlaneZ();
+  auto preStepPoint = step->GetPreStepPoint();
+  const auto& p1 = preStepPoint->GetPosition();
+  const auto& p2 = step->GetPostStepPoint()->GetPosition();
+  if ( p1.z() >= zPlane || p2.z() < zPlane ) return;
+
+  // The plane lies in the world vacuum, the pre-step kinematics
+  // hold at the crossing point
+  auto position = p1 + (p2 - p1)*((zPlane - p1.z())/(p2.z() - p1.z()));
+  auto eventID 
+    = G4EventManager::GetEventManager()->GetConstCurrentEvent()->GetEventID();
+  writer->Record(eventID, step->GetTrack()->GetDefinition()->GetPDGEncoding(),
+                 preStepPoint->GetKineticEnergy(), position, 
+                 preStepPoint->GetMomentumDirection());
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
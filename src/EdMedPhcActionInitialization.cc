@@ -32,6 +32,8 @@
 #include "EdMedPhPrimaryGeneratorAction.hh"
 #include "EdMedPhRunAction.hh"
 #include "EdMedPhcEventAction.hh"
+#include "EdMedPhSteppingAction.hh"
+#include "EdMedPhTrackingAction.hh"
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
@@ -55,9 +57,13 @@ void EdMedPhcActionInitialization::BuildForMaster() const
 
 void EdMedPhcActionInitialization::Build() const
 {
-  SetUserAction(new EdMedPhPrimaryGeneratorAction);
-  SetUserAction(new EdMedPhRunAction);
+  auto primaryGenerator = new EdMedPhPrimaryGeneratorAction;
+  SetUserAction(primaryGenerator);
+  auto runAction = new EdMedPhRunAction(primaryGenerator);
+  SetUserAction(runAction);
   SetUserAction(new EdMedPhcEventAction);
+  SetUserAction(new EdMedPhTrackingAction(runAction));
+  SetUserAction(new EdMedPhSteppingAction(runAction));
 }  
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
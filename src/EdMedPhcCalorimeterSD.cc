@@ -29,6 +29,9 @@
 /// \brief Implementation of the EdMedPhcCalorimeterSD class
 
 #include "EdMedPhcCalorimeterSD.hh"
+#include "EdMedPhRun.hh"
+#include "EdMedPhROI.hh"
+#include "EdMedPhHitBuffer.hh"
 #include "G4HCofThisEvent.hh"
 #include "G4Step.hh"
 #include "G4ThreeVector.hh"
@@ -36,6 +39,9 @@
 #include "G4SDManager.hh"
 #include "G4ios.hh"
 
+#include <algorithm>
+#include <chrono>
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 EdMedPhcCalorimeterSD::EdMedPhcCalorimeterSD(
@@ -43,8 +49,20 @@ EdMedPhcCalorimeterSD::EdMedPhcCalorimeterSD(
                             const G4String& hitsCollectionName,
                             G4int nofCells)
  : G4VSensitiveDetector(name),
-   fHitsCollection(nullptr),
-   fNofCells(nofCells)
+   fNofCells(nofCells),
+   fExportHits(false),
+   fHCID(-1),
+   fEntranceZ(0.),
+   fCellWidth(0.),
+   fDoseGrid(nullptr),
+   fHitBuffer(nullptr),
+   fEventID(-1),
+   fRun(nullptr),
+   fROIs(nullptr),
+   fNofCalls(0),
+   fNofTimedCalls(0),
+   fTimedCallsTime(0.),
+   fTimingCounter(0)
 {
   collectionName.insert(hitsCollectionName);
 }
@@ -57,34 +75,53 @@ EdMedPhcCalorimeterSD::~EdMedPhcCalorimeterSD()
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void EdMedPhcCalorimeterSD::Initialize(G4HCofThisEvent* hce)
+void EdMedPhcCalorimeterSD::Initialize(G4HCofThisEvent*)
 {
-  // Create hits collection
-  fHitsCollection 
-    = new EdMedPhcCalorHitsCollection(SensitiveDetectorName, collectionName[0]); 
-
-  // Add this collection in hce
-  auto hcID 
-    = G4SDManager::GetSDMpointer()->GetCollectionID(collectionName[0]);
-  hce->AddHitsCollection( hcID, fHitsCollection ); 
-
-  // Create hits
+  // Reset the sums
   // fNofCells for cells + one more for total sums 
-  for (G4int i=0; i<fNofCells+1; i++ ) {
-    fHitsCollection->insert(new EdMedPhcCalorHit());
-  }
+  fEdep.assign(fNofCells+1, 0.);
+  fTrackLength.assign(fNofCells+1, 0.);
+
+  // Pick up the thread-local scorers of the current run
+  auto runManager = G4RunManager::GetRunManager();
+  auto run = static_cast<EdMedPhRun*>(runManager->GetNonConstCurrentRun());
+  fDoseGrid = run->GetDoseGrid().IsEnabled() ? &run->GetDoseGrid() : nullptr;
+  fHitBuffer = run->GetHitBuffer();
+  fEventID = runManager->GetCurrentEvent()->GetEventID();
+  fRun = run;
+  fROIs = run->GetROIs();
+  fROIEdep.assign(( fROIs ? fROIs->size() : 0 ) + 1, 0.);
+
+  fNofCalls = 0;
+  fNofTimedCalls = 0;
+  fTimedCallsTime = 0.;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 G4bool EdMedPhcCalorimeterSD::ProcessHits(G4Step* step, 
                                      G4TouchableHistory*)
+{ 
+  ++fNofCalls;
+  if ( ++fTimingCounter % kTimingStride != 0 ) return ScoreStep(step);
+
+  auto start = std::chrono::steady_clock::now();
+  auto result = ScoreStep(step);
+  std::chrono::duration<G4double, std::nano> elapsed 
+    = std::chrono::steady_clock::now() - start;
+  ++fNofTimedCalls;
+  fTimedCallsTime += elapsed.count();
+  return result;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4bool EdMedPhcCalorimeterSD::ScoreStep(G4Step* step)
 { 
   // energy deposit
   auto edep = step->GetTotalEnergyDeposit();
-  auto EventID = G4RunManager::GetRunManager()->GetCurrentEvent()->GetEventID();
-  auto analysisManager = G4AnalysisManager::Instance();
   if(0.0 < edep) {
+    auto analysisManager = G4AnalysisManager::Instance();
 
     G4ThreeVector p1 = step->GetPreStepPoint()->GetPosition();
     G4ThreeVector p2 = step->GetPostStepPoint()->GetPosition();
@@ -100,15 +137,26 @@ G4bool EdMedPhcCalorimeterSD::ProcessHits(G4Step* step,
     G4double y0 = 0.5*(y1 + y2);
     G4double z0 = 0.5*(z1 + z2);
     //    G4double r0 = std::sqrt(x0*x0 + y0*y0);
-    analysisManager->FillH1(0,z0+25.*cm,edep);
-    //analysisManager->FillH1(1,z0+25.*cm,edep);
-    //analysisManager->FillH1(2,z0+25.*cm,edep);
-    analysisManager->FillNtupleDColumn(0, edep);
-    analysisManager->FillNtupleDColumn(1, x0);
-    analysisManager->FillNtupleDColumn(2, y0);
-    analysisManager->FillNtupleDColumn(3, z0+25.*cm);
-    analysisManager->FillNtupleDColumn(4, EventID);
-    analysisManager->AddNtupleRow();
+    analysisManager->FillH1(0,z0-fEntranceZ,edep);
+    //analysisManager->FillH1(1,z0-fEntranceZ,edep);
+    //analysisManager->FillH1(2,z0-fEntranceZ,edep);
+    if ( fDoseGrid ) {
+      fDoseGrid->Fill(x0, y0, z0-fEntranceZ, edep);
+    }
+    if ( fHitBuffer ) {
+      fHitBuffer->Append(edep, x0, y0, z0-fEntranceZ, fEventID);
+    }
+    if ( fROIs ) {
+      G4ThreeVector position(x0, y0, z0-fEntranceZ);
+      G4bool inside = false;
+      for ( std::size_t i = 0; i < fROIs->size(); ++i ) {
+        if ( (*fROIs)[i]->Contains(position) ) {
+          fROIEdep[i] += edep;
+          inside = true;
+        }
+      }
+      if ( ! inside ) fROIEdep.back() += edep;
+    }
   }
   // step length
   G4double stepLength = 0.;
@@ -119,42 +167,68 @@ G4bool EdMedPhcCalorimeterSD::ProcessHits(G4Step* step,
 
   if ( edep==0. && stepLength == 0. ) return false;      
 
-  auto touchable = (step->GetPreStepPoint()->GetTouchable());
-    
   // Get calorimeter cell id 
-  auto layerNumber = touchable->GetReplicaNumber(1);
+  G4int layerNumber;
+  if ( fCellWidth > 0. ) {
+    auto depth = 0.5*(step->GetPreStepPoint()->GetPosition().z() 
+                    + step->GetPostStepPoint()->GetPosition().z()) - fEntranceZ;
+    layerNumber = std::min(std::max(G4int(depth/fCellWidth), 0), fNofCells-1);
+  }
+  else {
+    auto touchable = (step->GetPreStepPoint()->GetTouchable());
+    layerNumber = touchable->GetReplicaNumber(1);
+  }
   
-  // Get hit accounting data for this cell
-  auto hit = (*fHitsCollection)[layerNumber];
-  if ( ! hit ) {
+  if ( layerNumber < 0 || layerNumber >= fNofCells ) {
     G4ExceptionDescription msg;
-    msg << "Cannot access hit " << layerNumber; 
-    G4Exception("EdMedPhcCalorimeterSD::ProcessHits()",
+    msg << "Cannot access cell " << layerNumber; 
+    G4Exception("EdMedPhcCalorimeterSD::ScoreStep()",
       "MyCode0004", FatalException, msg);
   }         
 
-  // Get hit for total accounting
-  auto hitTotal 
-    = (*fHitsCollection)[fHitsCollection->entries()-1];
-  
-  // Add values
-  hit->Add(edep, stepLength);
-  hitTotal->Add(edep, stepLength); 
+  // Add values to the cell and to the total
+  fEdep[layerNumber] += edep;
+  fTrackLength[layerNumber] += stepLength;
+  fEdep[fNofCells] += edep;
+  fTrackLength[fNofCells] += stepLength;
       
   return true;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-void EdMedPhcCalorimeterSD::EndOfEvent(G4HCofThisEvent*)
+void EdMedPhcCalorimeterSD::EndOfEvent(G4HCofThisEvent* hce)
 {
+  if ( fROIs ) fRun->AddROIEdep(fROIEdep);
+  fRun->AddProcessHits(SensitiveDetectorName, 
+                       fNofCalls, fNofTimedCalls, fTimedCallsTime);
+
+  if ( ! fExportHits ) return;
+
+  // Create hits collection
+  auto hitsCollection 
+    = new EdMedPhcCalorHitsCollection(SensitiveDetectorName, collectionName[0]); 
+
+  // Add this collection in hce
+  if ( fHCID < 0 ) {
+    fHCID = G4SDManager::GetSDMpointer()->GetCollectionID(collectionName[0]);
+  }
+  hce->AddHitsCollection( fHCID, hitsCollection ); 
+
+  // Create hits from the sums
+  for (G4int i=0; i<fNofCells+1; i++ ) {
+    auto hit = new EdMedPhcCalorHit();
+    hit->Add(fEdep[i], fTrackLength[i]);
+    hitsCollection->insert(hit);
+  }
+
   if ( verboseLevel>1 ) { 
-    long unsigned int nofHits = fHitsCollection->entries();
+    long unsigned int nofHits = hitsCollection->entries();
     G4cout
       << G4endl 
       << "-------->Hits Collection: in this event they are " << nofHits 
       << " hits in the tracker chambers: " << G4endl;
-    for ( long unsigned int i=0; i<nofHits; i++ ) (*fHitsCollection)[i]->Print();
+    for ( long unsigned int i=0; i<nofHits; i++ ) (*hitsCollection)[i]->Print();
   }
 }
 
@@ -30,16 +30,26 @@
 
 #include "EdMedPhcDetectorConstruction.hh"
 #include "EdMedPhcCalorimeterSD.hh"
+#include "EdMedPhDetectorMessenger.hh"
 #include "G4Material.hh"
 #include "G4NistManager.hh"
+#include "G4RunManager.hh"
+#include "G4StateManager.hh"
 
 #include "G4Box.hh"
 #include "G4LogicalVolume.hh"
 #include "G4PVPlacement.hh"
 #include "G4PVReplica.hh"
+#include "G4PVParameterised.hh"
+#include "G4PhantomParameterisation.hh"
 #include "G4GlobalMagFieldMessenger.hh"
 #include "G4AutoDelete.hh"
 
+#include "G4GeometryManager.hh"
+#include "G4PhysicalVolumeStore.hh"
+#include "G4LogicalVolumeStore.hh"
+#include "G4SolidStore.hh"
+
 #include "G4SDManager.hh"
 
 #include "G4VisAttributes.hh"
@@ -48,6 +58,8 @@
 #include "G4PhysicalConstants.hh"
 #include "G4SystemOfUnits.hh"
 
+#include <algorithm>
+
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 G4ThreadLocal 
@@ -57,26 +69,183 @@ G4GlobalMagFieldMessenger* EdMedPhcDetectorConstruction::fMagFieldMessenger = 0;
 
 EdMedPhcDetectorConstruction::EdMedPhcDetectorConstruction()
  : G4VUserDetectorConstruction(),
+   fMessenger(nullptr),
    fCheckOverlaps(true),
-   fNofLayers(-1)
+   fGeometryMode(kLayered),
+   fNofLayers(500),
+   fAbsoThickness(0.1*cm),
+   fGapThickness(0.000001*mm),
+   fCalorSizeXY(30.*cm),
+   fCalorThickness(0.),
+   fNofCells(0),
+   fCellWidth(0.),
+   fAbsorberMaterial(nullptr),
+   fGapMaterial(nullptr),
+   fGeometryChanged(true),
+   fWorldPV(nullptr),
+   fAbsorberLV(nullptr),
+   fGapLV(nullptr),
+   fRegularNavigation(true),
+   fCTParameterisation(nullptr),
+   fGapSD(false),
+   fExportHits(false)
 {
+  // Define materials 
+  DefineMaterials();
+  fAbsorberMaterial = G4Material::GetMaterial("G4_WATER");
+  fGapMaterial = G4Material::GetMaterial("Galactic");
+
+  fMessenger = new EdMedPhDetectorMessenger(this);
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 EdMedPhcDetectorConstruction::~EdMedPhcDetectorConstruction()
 { 
+  delete fCTParameterisation;
+  delete fMessenger;
 }  
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 G4VPhysicalVolume* EdMedPhcDetectorConstruction::Construct()
 {
-  // Define materials 
-  DefineMaterials();
-  
+  // Nothing to rebuild, material changes are applied in place
+  if ( fWorldPV && ! fGeometryChanged ) return fWorldPV;
+
+  // Clean the old geometry, if any
+  G4GeometryManager::GetInstance()->OpenGeometry();
+  G4PhysicalVolumeStore::GetInstance()->Clean();
+  G4LogicalVolumeStore::GetInstance()->Clean();
+  G4SolidStore::GetInstance()->Clean();
+  fAbsorberLV = nullptr;
+  fGapLV = nullptr;
+  delete fCTParameterisation;
+  fCTParameterisation = nullptr;
+
   // Define volumes
-  return DefineVolumes();
+  fWorldPV = DefineVolumes();
+  fGeometryChanged = false;
+  return fWorldPV;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+G4Material* EdMedPhcDetectorConstruction::FindMaterial(
+                                            const G4String& name) const
+{
+  auto material = G4Material::GetMaterial(name, false);
+  if ( ! material ) {
+    material = G4NistManager::Instance()->FindOrBuildMaterial(name);
+  }
+  if ( ! material ) {
+    G4ExceptionDescription msg;
+    msg << "Material " << name << " not found, the command is ignored."; 
+    G4Exception("EdMedPhcDetectorConstruction::FindMaterial()",
+      "MyCode0012", JustWarning, msg);
+  }
+  return material;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhcDetectorConstruction::GeometryHasChanged()
+{
+  fGeometryChanged = true;
+
+  // Once initialised, the volumes are replaced at the next run
+  auto state = G4StateManager::GetStateManager()->GetCurrentState();
+  if ( state != G4State_PreInit ) {
+    G4RunManager::GetRunManager()->ReinitializeGeometry();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhcDetectorConstruction::SetGeometryMode(GeometryMode mode)
+{
+  if ( mode == fGeometryMode ) return;
+  fGeometryMode = mode;
+  GeometryHasChanged();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhcDetectorConstruction::SetNofLayers(G4int value)
+{
+  fNofLayers = value;
+  GeometryHasChanged();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhcDetectorConstruction::SetAbsoThickness(G4double value)
+{
+  fAbsoThickness = value;
+  GeometryHasChanged();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhcDetectorConstruction::SetGapThickness(G4double value)
+{
+  fGapThickness = value;
+  GeometryHasChanged();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhcDetectorConstruction::SetCalorSizeXY(G4double value)
+{
+  fCalorSizeXY = value;
+  GeometryHasChanged();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhcDetectorConstruction::SetCTFile(const G4String& fileName)
+{
+  fCTFileName = fileName;
+  if ( fGeometryMode == kCT ) GeometryHasChanged();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhcDetectorConstruction::SetRegularNavigation(G4bool value)
+{
+  if ( value == fRegularNavigation ) return;
+  fRegularNavigation = value;
+  if ( fGeometryMode == kCT ) GeometryHasChanged();
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhcDetectorConstruction::SetAbsorberMaterial(const G4String& name)
+{
+  auto material = FindMaterial(name);
+  if ( ! material || material == fAbsorberMaterial ) return;
+  fAbsorberMaterial = material;
+
+  // The volumes are kept, only the physics tables need an update
+  if ( fAbsorberLV ) {
+    fAbsorberLV->SetMaterial(material);
+    G4RunManager::GetRunManager()->PhysicsHasBeenModified();
+  }
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhcDetectorConstruction::SetGapMaterial(const G4String& name)
+{
+  auto material = FindMaterial(name);
+  if ( ! material || material == fGapMaterial ) return;
+  fGapMaterial = material;
+
+  // The volumes are kept, only the physics tables need an update
+  if ( fGapLV ) {
+    fGapLV->SetMaterial(material);
+    G4RunManager::GetRunManager()->PhysicsHasBeenModified();
+  }
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -107,20 +276,41 @@ void EdMedPhcDetectorConstruction::DefineMaterials()
 G4VPhysicalVolume* EdMedPhcDetectorConstruction::DefineVolumes()
 {
   // Geometry parameters
-  fNofLayers = 500;
-  G4double absoThickness = 0.1*cm;
-  G4double gapThickness =  0.000001*mm;
-  G4double calorSizeXY  = 30.*cm;
-
-  auto layerThickness = absoThickness + gapThickness;
-  auto calorThickness = fNofLayers * layerThickness;
-  auto worldSizeXY = 1.2 * calorSizeXY;
-  auto worldSizeZ  = 1.2 * calorThickness; 
+  auto calorSizeX = fCalorSizeXY;
+  auto calorSizeY = fCalorSizeXY;
+  if ( fGeometryMode == kCT ) {
+    // the phantom file defines the size and the scoring cells
+    if ( fCTFileName.empty() ) {
+      G4ExceptionDescription msg;
+      msg << "No CT phantom file, set one with /EdMedPh/det/ctFile."; 
+      G4Exception("EdMedPhDetectorConstruction::DefineVolumes()",
+        "MyCode0013", FatalException, msg);
+    }
+    fCTPhantom.Read(fCTFileName);
+    calorSizeX = fCTPhantom.GetSize().x();
+    calorSizeY = fCTPhantom.GetSize().y();
+    fCalorThickness = fCTPhantom.GetSize().z();
+    fNofCells = fCTPhantom.GetNz();
+    fCellWidth = fCTPhantom.GetVoxelSize().z();
+  }
+  else if ( fGeometryMode == kSolid ) {
+    // no gaps: the layers are only a readout binning
+    fCalorThickness = fNofLayers * fAbsoThickness;
+    fNofCells = fNofLayers;
+    fCellWidth = fAbsoThickness;
+  }
+  else {
+    fCalorThickness = fNofLayers * (fAbsoThickness + fGapThickness);
+    fNofCells = fNofLayers;
+    fCellWidth = 0.;
+  }
+  auto worldSizeXY = 1.2 * std::max(calorSizeX, calorSizeY);
+  auto worldSizeZ  = 1.2 * fCalorThickness; 
   
   // Get materials
   auto defaultMaterial = G4Material::GetMaterial("Galactic");
-  auto absorberMaterial = G4Material::GetMaterial("G4_WATER");
-  auto gapMaterial = G4Material::GetMaterial("Galactic");
+  auto absorberMaterial = fAbsorberMaterial;
+  auto gapMaterial = fGapMaterial;
   
   if ( ! defaultMaterial || ! absorberMaterial || ! gapMaterial ) {
     G4ExceptionDescription msg;
@@ -158,7 +348,7 @@ G4VPhysicalVolume* EdMedPhcDetectorConstruction::DefineVolumes()
   //  
   auto calorimeterS
     = new G4Box("Calorimeter",     // its name
-                 calorSizeXY/2, calorSizeXY/2, calorThickness/2); // its size
+                 calorSizeX/2, calorSizeY/2, fCalorThickness/2); // its size
                          
   auto calorLV
     = new G4LogicalVolume(
@@ -166,7 +356,8 @@ G4VPhysicalVolume* EdMedPhcDetectorConstruction::DefineVolumes()
                  defaultMaterial,  // its material
                  "Calorimeter");   // its name
                                    
-  new G4PVPlacement(
+  auto calorPV
+    = new G4PVPlacement(
                  0,                // no rotation
                  G4ThreeVector(),  // at (0,0,0)
                  calorLV,          // its logical volume                         
@@ -175,13 +366,47 @@ G4VPhysicalVolume* EdMedPhcDetectorConstruction::DefineVolumes()
                  false,            // no boolean operation
                  0,                // copy number
                  fCheckOverlaps);  // checking overlaps 
-   
+
+  if ( fGeometryMode == kCT ) {
+    DefineCTPhantom(calorPV);
+  }
+  else if ( fGeometryMode == kSolid ) {
+    DefineSolidPhantom(calorLV, absorberMaterial);
+  }
+  else {
+    DefineLayers(calorLV, defaultMaterial, absorberMaterial, gapMaterial);
+  }
+  
+  //                                        
+  // Visualization attributes
+  //
+  worldLV->SetVisAttributes (G4VisAttributes::GetInvisible());
+
+  auto simpleBoxVisAtt= new G4VisAttributes(G4Colour(0.,0.47,0.75));
+  simpleBoxVisAtt->SetVisibility(true);
+  calorLV->SetVisAttributes(simpleBoxVisAtt);
+
+  //
+  // Always return the physical World
+  //
+  return worldPV;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhcDetectorConstruction::DefineLayers(G4LogicalVolume* calorLV,
+                                                G4Material* defaultMaterial,
+                                                G4Material* absorberMaterial,
+                                                G4Material* gapMaterial)
+{
+  auto layerThickness = fAbsoThickness + fGapThickness;
+
   //                                 
   // Layer
   //
   auto layerS 
     = new G4Box("Layer",           // its name
-                 calorSizeXY/2, calorSizeXY/2, layerThickness/2); //its size
+                 fCalorSizeXY/2, fCalorSizeXY/2, layerThickness/2); //its size
                          
   auto layerLV
     = new G4LogicalVolume(
@@ -202,7 +427,7 @@ G4VPhysicalVolume* EdMedPhcDetectorConstruction::DefineVolumes()
   //
   auto absorberS 
     = new G4Box("Abso",            // its name
-                 calorSizeXY/2, calorSizeXY/2, absoThickness/2); // its size
+                 fCalorSizeXY/2, fCalorSizeXY/2, fAbsoThickness/2); // its size
                          
   auto absorberLV
     = new G4LogicalVolume(
@@ -212,7 +437,7 @@ G4VPhysicalVolume* EdMedPhcDetectorConstruction::DefineVolumes()
                                    
    new G4PVPlacement(
                  0,                // no rotation
-                 G4ThreeVector(0., 0., -gapThickness/2), // its position
+                 G4ThreeVector(0., 0., -fGapThickness/2), // its position
                  absorberLV,       // its logical volume                         
                  "Abso",           // its name
                  layerLV,          // its mother  volume
@@ -225,7 +450,7 @@ G4VPhysicalVolume* EdMedPhcDetectorConstruction::DefineVolumes()
   //
   auto gapS 
     = new G4Box("Gap",             // its name
-                 calorSizeXY/2, calorSizeXY/2, gapThickness/2); // its size
+                 fCalorSizeXY/2, fCalorSizeXY/2, fGapThickness/2); // its size
                          
   auto gapLV
     = new G4LogicalVolume(
@@ -235,7 +460,7 @@ G4VPhysicalVolume* EdMedPhcDetectorConstruction::DefineVolumes()
                                    
   new G4PVPlacement(
                  0,                // no rotation
-                 G4ThreeVector(0., 0., absoThickness/2), // its position
+                 G4ThreeVector(0., 0., fAbsoThickness/2), // its position
                  gapLV,            // its logical volume                         
                  "Gap",            // its name
                  layerLV,          // its mother  volume
@@ -243,6 +468,9 @@ G4VPhysicalVolume* EdMedPhcDetectorConstruction::DefineVolumes()
                  0,                // copy number
                  fCheckOverlaps);  // checking overlaps 
  
+  fAbsorberLV = absorberLV;
+  fGapLV = gapLV;
+
   //
   // print parameters
   //
@@ -250,22 +478,113 @@ G4VPhysicalVolume* EdMedPhcDetectorConstruction::DefineVolumes()
     << G4endl 
     << "------------------------------------------------------------" << G4endl
     << "---> The calorimeter is " << fNofLayers << " layers of: [ "
-    << absoThickness/mm << "mm of " << absorberMaterial->GetName() 
+    << fAbsoThickness/mm << "mm of " << absorberMaterial->GetName() 
     << "------------------------------------------------------------" << G4endl;
-  
-  //                                        
-  // Visualization attributes
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhcDetectorConstruction::DefineSolidPhantom(
+                                     G4LogicalVolume* calorLV,
+                                     G4Material* absorberMaterial)
+{
+  //                               
+  // Absorber filling the whole calorimeter
   //
-  worldLV->SetVisAttributes (G4VisAttributes::GetInvisible());
+  auto absorberS 
+    = new G4Box("Abso",            // its name
+                 fCalorSizeXY/2, fCalorSizeXY/2, fCalorThickness/2); // its size
+                         
+  auto absorberLV
+    = new G4LogicalVolume(
+                 absorberS,        // its solid
+                 absorberMaterial, // its material
+                 "AbsoLV");        // its name
+                                   
+   new G4PVPlacement(
+                 0,                // no rotation
+                 G4ThreeVector(),  // at (0,0,0)
+                 absorberLV,       // its logical volume                         
+                 "Abso",           // its name
+                 calorLV,          // its mother  volume
+                 false,            // no boolean operation
+                 0,                // copy number
+                 fCheckOverlaps);  // checking overlaps 
 
-  auto simpleBoxVisAtt= new G4VisAttributes(G4Colour(0.,0.47,0.75));
-  simpleBoxVisAtt->SetVisibility(true);
-  calorLV->SetVisAttributes(simpleBoxVisAtt);
+  fAbsorberLV = absorberLV;
 
   //
-  // Always return the physical World
+  // print parameters
   //
-  return worldPV;
+  G4cout
+    << G4endl 
+    << "------------------------------------------------------------" << G4endl
+    << "---> The phantom is " << fCalorThickness/mm << "mm of " 
+    << absorberMaterial->GetName() << ", scored in " << fNofLayers 
+    << " cells of " << fAbsoThickness/mm << "mm" << G4endl
+    << "------------------------------------------------------------" << G4endl;
+}
+
+//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
+
+void EdMedPhcDetectorConstruction::DefineCTPhantom(G4VPhysicalVolume* calorPV)
+{
+  auto voxelSize = fCTPhantom.GetVoxelSize();
+  auto& materials = fCTPhantom.GetMaterials();
+
+  //                               
+  // Voxel, its material is set by the parameterisation
+  //
+  auto voxelS 
+    = new G4Box("Voxel",           // its name
+                 voxelSize.x()/2, voxelSize.y()/2, voxelSize.z()/2); // its size
+                         
+  auto voxelLV
+    = new G4LogicalVolume(
+                 voxelS,           // its solid
+                 materials[0],     // its material
+                 "AbsoLV");        // its name
+
+  //                               
+  // Parameterisation filling the calorimeter with the voxels
+  //
+  fCTParameterisation = new G4PhantomParameterisation();
+  fCTParameterisation->SetVoxelDimensions(
+    voxelSize.x()/2, voxelSize.y()/2, voxelSize.z()/2);
+  fCTParameterisation->SetNoVoxel(
+    fCTPhantom.GetNx(), fCTPhantom.GetNy(), fCTPhantom.GetNz());
+  fCTParameterisation->SetMaterials(materials);
+  fCTParameterisation->SetMaterialIndices(fCTPhantom.GetMaterialIndices());
+  fCTParameterisation->BuildContainerSolid(calorPV);
+  auto calorSize = fCTPhantom.GetSize();
+  fCTParameterisation->CheckVoxelsFillContainer(
+    calorSize.x()/2, calorSize.y()/2, calorSize.z()/2);
+
+  auto nofVoxels 
+    = fCTPhantom.GetNx() * fCTPhantom.GetNy() * fCTPhantom.GetNz();
+  auto phantomPV 
+    = new G4PVParameterised(
+                 "Phantom",        // its name
+                 voxelLV,          // its logical volume
+                 calorPV->GetLogicalVolume(), // its mother volume
+                 kUndefined,       // voxels along all axes
+                 nofVoxels,        // number of voxels
+                 fCTParameterisation); // its parameterisation
+
+  // 1 selects G4RegularNavigation, 0 the generic parameterised navigation
+  phantomPV->SetRegularStructureId(fRegularNavigation ? 1 : 0);
+
+  //
+  // print parameters
+  //
+  G4cout
+    << G4endl 
+    << "------------------------------------------------------------" << G4endl
+    << "---> The phantom is " << fCTPhantom.GetNx() << " x " 
+    << fCTPhantom.GetNy() << " x " << fCTPhantom.GetNz() << " voxels of " 
+    << voxelSize/mm << " mm, " << materials.size() << " materials, " 
+    << ( fRegularNavigation ? "regular" : "generic" ) << " navigation" << G4endl
+    << "------------------------------------------------------------" << G4endl;
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -277,15 +596,37 @@ void EdMedPhcDetectorConstruction::ConstructSDandField()
   // 
   // Sensitive detectors
   //
-  auto absoSD 
-    = new EdMedPhcCalorimeterSD("AbsorberSD", "AbsorberHitsCollection", fNofLayers);
-  G4SDManager::GetSDMpointer()->AddNewDetector(absoSD);
+  // The detectors are reused when the geometry is rebuilt,
+  // with the cell layout of the new one
+  auto sdManager = G4SDManager::GetSDMpointer();
+  auto absoSD = static_cast<EdMedPhcCalorimeterSD*>(
+    sdManager->FindSensitiveDetector("AbsorberSD", false));
+  if ( ! absoSD ) {
+    absoSD 
+      = new EdMedPhcCalorimeterSD("AbsorberSD", "AbsorberHitsCollection", fNofCells);
+    sdManager->AddNewDetector(absoSD);
+  }
+  absoSD->SetNofCells(fNofCells);
+  absoSD->SetEntranceZ(-fCalorThickness/2);
+  absoSD->SetCellWidth(fCellWidth);
+  absoSD->SetExportHits(fExportHits);
   SetSensitiveDetector("AbsoLV",absoSD);
 
-  auto gapSD 
-    = new EdMedPhcCalorimeterSD("GapSD", "GapHitsCollection", fNofLayers);
-  G4SDManager::GetSDMpointer()->AddNewDetector(gapSD);
-  SetSensitiveDetector("GapLV",gapSD);
+  // the gaps are scored only on request, 
+  // there are none in the solid and CT phantoms
+  if ( fGapSD && fGeometryMode == kLayered ) {
+    auto gapSD = static_cast<EdMedPhcCalorimeterSD*>(
+      sdManager->FindSensitiveDetector("GapSD", false));
+    if ( ! gapSD ) {
+      gapSD 
+        = new EdMedPhcCalorimeterSD("GapSD", "GapHitsCollection", fNofLayers);
+      sdManager->AddNewDetector(gapSD);
+    }
+    gapSD->SetNofCells(fNofLayers);
+    gapSD->SetEntranceZ(-fCalorThickness/2);
+    gapSD->SetExportHits(fExportHits);
+    SetSensitiveDetector("GapLV",gapSD);
+  }
 
   // 
   // Magnetic field
@@ -293,6 +634,8 @@ void EdMedPhcDetectorConstruction::ConstructSDandField()
   // Create global magnetic field messenger.
   // Uniform magnetic field is then created automatically if
   // the field value is not zero.
+  // (only once per thread, it survives geometry rebuilds)
+  if ( fMagFieldMessenger ) return;
   G4ThreeVector fieldValue;
   fMagFieldMessenger = new G4GlobalMagFieldMessenger(fieldValue);
   fMagFieldMessenger->SetVerboseLevel(1);
@@ -30,14 +30,18 @@
 
 #include "EdMedPhcEventAction.hh"
 #include "EdMedPhcCalorimeterSD.hh"
-#include "EdMedPhcCalorHit.hh"
+#include "EdMedPhRun.hh"
 #include "EdMedPhAnalysis.hh"
+#include "EdMedPhProgressReporter.hh"
 
 #include "G4RunManager.hh"
 #include "G4Event.hh"
+#include "G4PrimaryVertex.hh"
+#include "G4PrimaryParticle.hh"
 #include "G4SDManager.hh"
 #include "G4HCofThisEvent.hh"
 #include "G4UnitsTable.hh"
+#include "G4Threading.hh"
 
 #include "Randomize.hh"
 #include <iomanip>
@@ -46,8 +50,8 @@
 
 EdMedPhcEventAction::EdMedPhcEventAction()
  : G4UserEventAction(),
-   fAbsHCID(-1),
-   fGapHCID(-1)
+   fAbsoSD(nullptr),
+   fProgressSlot(G4Threading::G4GetThreadId() + 1)
 {}
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
@@ -57,26 +61,6 @@ EdMedPhcEventAction::~EdMedPhcEventAction()
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
-EdMedPhcCalorHitsCollection* 
-EdMedPhcEventAction::GetHitsCollection(G4int hcID,
-                                  const G4Event* event) const
-{
-  auto hitsCollection 
-    = static_cast<EdMedPhcCalorHitsCollection*>(
-        event->GetHCofThisEvent()->GetHC(hcID));
-  
-  if ( ! hitsCollection ) {
-    G4ExceptionDescription msg;
-    msg << "Cannot access hitsCollection ID " << hcID; 
-    G4Exception("EdMedPhcEventAction::GetHitsCollection()",
-      "MyCode0003", FatalException, msg);
-  }         
-
-  return hitsCollection;
-}    
-
-//....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
-
 void EdMedPhcEventAction::PrintEventStatistics(G4double absoEdep, G4double absoTrackLength) const
 {
   // print event statistics
@@ -92,37 +76,61 @@ void EdMedPhcEventAction::PrintEventStatistics(G4double absoEdep, G4double absoT
 
 void EdMedPhcEventAction::BeginOfEventAction(const G4Event*)
 {
+  fEventTimer.Start();
 }
 
 //....oooOO0OOooo........oooOO0OOooo........oooOO0OOooo........oooOO0OOooo......
 
 void EdMedPhcEventAction::EndOfEventAction(const G4Event* event)
 {  
-  // Get hits collections IDs (only once)
-  if ( fAbsHCID == -1 ) {
-    fAbsHCID 
-      = G4SDManager::GetSDMpointer()->GetCollectionID("AbsorberHitsCollection");
-    fGapHCID 
-      = G4SDManager::GetSDMpointer()->GetCollectionID("GapHitsCollection");
+  EdMedPhProgressReporter::Instance()->CountEvent(fProgressSlot);
+
+  // Get the absorber sensitive detector (only once),
+  // it holds the per-layer sums of this event
+  if ( ! fAbsoSD ) {
+    fAbsoSD = static_cast<EdMedPhcCalorimeterSD*>(
+      G4SDManager::GetSDMpointer()->FindSensitiveDetector("AbsorberSD"));
+  }
+ 
+  // Fill the event summary ntuple
+  //
+  auto eventID = event->GetEventID();
+  auto run = static_cast<EdMedPhRun*>(
+    G4RunManager::GetRunManager()->GetNonConstCurrentRun());
+  auto ntupleId = run->GetEventNtupleId();
+  if ( ntupleId >= 0 ) {
+    G4double primaryEnergy = 0.;
+    for ( G4int i = 0; i < event->GetNumberOfPrimaryVertex(); ++i ) {
+      auto vertex = event->GetPrimaryVertex(i);
+      for ( G4int j = 0; j < vertex->GetNumberOfParticle(); ++j ) {
+        primaryEnergy += vertex->GetPrimary(j)->GetKineticEnergy();
+      }
+    }
+
+    auto analysisManager = G4AnalysisManager::Instance();
+    analysisManager->FillNtupleIColumn(ntupleId, 0, eventID);
+    analysisManager->FillNtupleDColumn(ntupleId, 1, fAbsoSD->GetTotalEdep());
+    analysisManager->FillNtupleDColumn(ntupleId, 2, fAbsoSD->GetTumourEdep());
+    analysisManager->FillNtupleDColumn(ntupleId, 3, 
+                                       fAbsoSD->GetTotalTrackLength());
+    analysisManager->FillNtupleDColumn(ntupleId, 4, primaryEnergy);
+    analysisManager->AddNtupleRow(ntupleId);
   }
 
-  // Get hits collections
-  auto absoHC = GetHitsCollection(fAbsHCID, event);
-  //  auto gapHC = GetHitsCollection(fGapHCID, event);
+  // the sensitive detectors have all added their region deposits
+  run->EndROIEvent();
+
+  fEventTimer.Stop();
+  run->AddBusyTime(fEventTimer.GetRealElapsed());
 
-  // Get hit with total values
-  auto absoHit = (*absoHC)[absoHC->entries()-1];
-  //  auto gapHit = (*gapHC)[gapHC->entries()-1];
- 
   // Print per event (modulo n)
   //
-  auto eventID = event->GetEventID();
   auto printModulo = G4RunManager::GetRunManager()->GetPrintProgress();
   if ( ( printModulo > 0 ) && ( eventID % printModulo == 0 ) ) {
     G4cout << "---> End of event: " << eventID << G4endl;     
 
     PrintEventStatistics(
-      absoHit->GetEdep(), absoHit->GetTrackLength());
+      fAbsoSD->GetTotalEdep(), fAbsoSD->GetTotalTrackLength());
    
   
   // Fill histograms, ntuple
@@ -32,11 +32,7 @@
 #include "EdMedPhcActionInitialization.hh"
 #include "EdMedPhRunAction.hh"
 
-#ifdef G4MULTITHREADED
-#include "G4MTRunManager.hh"
-#else
-#include "G4RunManager.hh"
-#endif
+#include "G4RunManagerFactory.hh"
 
 #include "G4UImanager.hh"
 #include "G4UIcommand.hh"
@@ -52,9 +48,22 @@
 namespace {
   void PrintUsage() {
     G4cerr << " Usage: " << G4endl;
-    G4cerr << " exampleEdMedPhc [-m macro ] [-u UIsession] [-t nThreads]" << G4endl;
+    G4cerr << " exampleEdMedPhc [-m macro ] [-u UIsession] [-o output]"
+           << " [-t nThreads] [-r serial|mt|tasking] [-e ranecu|mixmax]"
+           << G4endl
+           << "                 [-s shardIndex/nofShards] [-v on|off]" << G4endl;
     G4cerr << "   note: -t option is available only for multi-threaded mode."
            << G4endl;
+    G4cerr << "   note: -r tasking schedules the events in chunks of"
+           << " /run/eventModulo events," << G4endl;
+    G4cerr << "         without -r the run manager is mt, as in earlier versions"
+           << " (serial in a sequential build)." << G4endl;
+    G4cerr << "   note: -e chooses the random engine, reseeded at each event"
+           << " (see /EdMedPh/random/)." << G4endl;
+    G4cerr << "   note: with -s, /EdMedPh/run/beamOn runs only the shard's share"
+           << " of the events," << G4endl;
+    G4cerr << "         the shard outputs are combined with EdMedPhc_merge."
+           << G4endl;
   }
 }
 
@@ -64,31 +73,74 @@ int main(int argc,char** argv)
 {
   // Evaluate arguments
   //
-  if ( argc > 7 ) {
+  if ( argc > 17 ) {
     PrintUsage();
     return 1;
   }
   
   G4String macro;
   G4String session;
-#ifdef G4MULTITHREADED
+  G4String runManagerTypeName;
+  G4String engineName = "ranecu";
+  G4String shard;
+  G4String vis = "on";
   G4int nThreads = 0;
-#endif
   for ( G4int i=1; i<argc; i=i+2 ) {
     if      ( G4String(argv[i]) == "-m" ) macro = argv[i+1];
     else if ( G4String(argv[i]) == "-u" ) session = argv[i+1];
     else if ( G4String(argv[i]) == "-o" ) outputFileName = argv[i+1];
-#ifdef G4MULTITHREADED
+    else if ( G4String(argv[i]) == "-r" ) runManagerTypeName = argv[i+1];
+    else if ( G4String(argv[i]) == "-e" ) engineName = argv[i+1];
+    else if ( G4String(argv[i]) == "-s" ) shard = argv[i+1];
+    else if ( G4String(argv[i]) == "-v" ) vis = argv[i+1];
     else if ( G4String(argv[i]) == "-t" ) {
       nThreads = G4UIcommand::ConvertToInt(argv[i+1]);
     }
-#endif
     else {
       PrintUsage();
       return 1;
     }
   }  
   
+  // Run manager type, MT by default in a multi-threaded build
+  //
+#ifdef G4MULTITHREADED
+  auto runManagerType = G4RunManagerType::MT;
+#else
+  auto runManagerType = G4RunManagerType::Serial;
+#endif
+  if      ( runManagerTypeName == "serial" ) {
+    runManagerType = G4RunManagerType::Serial;
+  }
+  else if ( runManagerTypeName == "mt" ) {
+    runManagerType = G4RunManagerType::MT;
+  }
+  else if ( runManagerTypeName == "tasking" ) {
+    runManagerType = G4RunManagerType::Tasking;
+  }
+  else if ( runManagerTypeName.size() ) {
+    PrintUsage();
+    return 1;
+  }
+
+  if ( ( engineName != "ranecu" && engineName != "mixmax" ) 
+       || ( vis != "on" && vis != "off" ) 
+       || ( vis == "off" && ! macro.size() ) ) {
+    PrintUsage();
+    return 1;
+  }
+
+  // Shard of a split job, as "index count" for /EdMedPh/run/shard
+  //
+  if ( shard.size() ) {
+    auto slash = shard.find('/');
+    if ( slash == std::string::npos ) {
+      PrintUsage();
+      return 1;
+    }
+    shard[slash] = ' ';
+  }
+
   // Detect interactive mode (if no macro provided) and define UI session
   //
   G4UIExecutive* ui = 0;
@@ -96,20 +148,22 @@ int main(int argc,char** argv)
     ui = new G4UIExecutive(argc, argv, session);
   }
 
-  // Choose the Random engine
+  // Choose the Random engine, the worker threads use the same type
   //
-  G4Random::setTheEngine(new CLHEP::RanecuEngine);
+  if ( engineName == "mixmax" ) {
+    G4Random::setTheEngine(new CLHEP::MixMaxRng);
+  }
+  else {
+    G4Random::setTheEngine(new CLHEP::RanecuEngine);
+  }
   
-  // Construct the default run manager
+  // Construct the run manager, MT unless chosen with -r;
+  // the tasking run manager hands the events to idle threads in chunks
   //
-#ifdef G4MULTITHREADED
-  G4MTRunManager * runManager = new G4MTRunManager;
+  auto runManager = G4RunManagerFactory::CreateRunManager(runManagerType);
   if ( nThreads > 0 ) { 
     runManager->SetNumberOfThreads(nThreads);
   }  
-#else
-  G4RunManager * runManager = new G4RunManager;
-#endif
 
   // Set mandatory initialization classes
   //
@@ -124,15 +178,22 @@ int main(int argc,char** argv)
   auto actionInitialization = new EdMedPhcActionInitialization();
   runManager->SetUserInitialization(actionInitialization);
   
-  // Initialize visualization
-  auto visManager = new G4VisExecutive;
-  // G4VisExecutive can take a verbosity argument - see /vis/verbose guidance.
-  // G4VisManager* visManager = new G4VisExecutive("Quiet");
-  visManager->Initialize();
+  // Initialize visualization, unless switched off for a batch run
+  G4VisExecutive* visManager = nullptr;
+  if ( vis == "on" ) {
+    visManager = new G4VisExecutive;
+    // G4VisExecutive can take a verbosity argument - see /vis/verbose guidance.
+    // G4VisManager* visManager = new G4VisExecutive("Quiet");
+    visManager->Initialize();
+  }
 
   // Get the pointer to the User Interface manager
   auto UImanager = G4UImanager::GetUIpointer();
 
+  if ( shard.size() ) {
+    UImanager->ApplyCommand("/EdMedPh/run/shard " + shard);
+  }
+
   // Process macro or start UI session
   //
   if ( macro.size() ) {